@@ -0,0 +1,119 @@
+#include <new>
+#include <atomic>
+#include <stdlib.h>
+#include "alloc_stats.h"
+
+// Every global new and delete is replaced, so memory from any of them
+// (the library's nothrow temporary buffers included) is malloc'd here
+// and given back to free.
+
+static std::atomic<unsigned long long> alloc_count(0);
+
+static void * counted_alloc(size_t size) {
+	alloc_count.fetch_add(1, std::memory_order_relaxed);
+	return malloc(size ? size : 1);
+}
+
+void * operator new(size_t size) {
+	void * p=counted_alloc(size);
+	if(p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void * operator new[](size_t size) {
+	return operator new(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept {
+	return counted_alloc(size);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept {
+	return counted_alloc(size);
+}
+
+void operator delete(void * p) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p) noexcept {
+	free(p);
+}
+
+void operator delete(void * p, size_t) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept {
+	free(p);
+}
+
+void operator delete(void * p, const std::nothrow_t &) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p, const std::nothrow_t &) noexcept {
+	free(p);
+}
+
+#ifdef __cpp_aligned_new
+static void * counted_alloc(size_t size, std::align_val_t align) {
+	alloc_count.fetch_add(1, std::memory_order_relaxed);
+	size_t a=(size_t)align < sizeof(void *) ? sizeof(void *) : (size_t)align;
+	void * p=NULL;
+	if(posix_memalign(&p, a, size ? size : 1) != 0) {
+		return NULL;
+	}
+	return p;
+}
+
+void * operator new(size_t size, std::align_val_t align) {
+	void * p=counted_alloc(size, align);
+	if(p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void * operator new[](size_t size, std::align_val_t align) {
+	return operator new(size, align);
+}
+
+void * operator new(size_t size, std::align_val_t align, const std::nothrow_t &) noexcept {
+	return counted_alloc(size, align);
+}
+
+void * operator new[](size_t size, std::align_val_t align, const std::nothrow_t &) noexcept {
+	return counted_alloc(size, align);
+}
+
+void operator delete(void * p, std::align_val_t) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p, std::align_val_t) noexcept {
+	free(p);
+}
+
+void operator delete(void * p, size_t, std::align_val_t) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p, size_t, std::align_val_t) noexcept {
+	free(p);
+}
+
+void operator delete(void * p, std::align_val_t, const std::nothrow_t &) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p, std::align_val_t, const std::nothrow_t &) noexcept {
+	free(p);
+}
+#endif
+
+unsigned long long get_alloc_count() {
+	return alloc_count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,13 @@
+#ifndef __ALLOC_STATS_H__
+#define __ALLOC_STATS_H__
+
+
+/******************************************
+* Counts calls to the global operator new,
+* so the solver can report how many heap
+* allocations a stage of the search made.
+******************************************/
+unsigned long long get_alloc_count();
+
+
+#endif
@@ -0,0 +1,123 @@
+#include <utility>
+#include <algorithm>
+#include "assignment.h"
+
+
+Assignment::Assignment() {
+	num_of_vars 	=	0;
+	num_of_words 	=	0;
+	words 			=	inline_words;
+}
+
+Assignment::Assignment(const Assignment & other) {
+	num_of_vars 	=	0;
+	num_of_words 	=	0;
+	words 			=	inline_words;
+	*this=other;
+}
+
+Assignment::Assignment(Assignment && other) {
+	num_of_vars 	=	0;
+	num_of_words 	=	0;
+	words 			=	inline_words;
+	*this=std::move(other);
+}
+
+Assignment & Assignment::operator=(const Assignment & other) {
+	if(this == &other) {
+		return *this;
+	}
+	if(num_of_words != other.num_of_words) {
+		if(words != inline_words) {
+			delete [] words;
+		}
+		words=(other.num_of_words <= ASSIGN_INLINE_WORDS) ? inline_words : new uint64_t[2*other.num_of_words];
+	}
+	num_of_vars 	=	other.num_of_vars;
+	num_of_words 	=	other.num_of_words;
+	memcpy(words, other.words, 2*num_of_words*sizeof(uint64_t));
+	return *this;
+}
+
+Assignment & Assignment::operator=(Assignment && other) {
+	if(this == &other) {
+		return *this;
+	}
+	if(other.words == other.inline_words) {
+		return *this=(const Assignment &)other;
+	}
+	if(words != inline_words) {
+		delete [] words;
+	}
+	num_of_vars 	=	other.num_of_vars;
+	num_of_words 	=	other.num_of_words;
+	words 			=	other.words;
+	other.num_of_vars 	=	0;
+	other.num_of_words 	=	0;
+	other.words 		=	other.inline_words;
+	return *this;
+}
+
+Assignment::~Assignment() {
+	if(words != inline_words) {
+		delete [] words;
+	}
+}
+
+// vars past num_of_vars (up to max_var) get words but are never counted
+// as needing a value, so literals on them simply stay unassigned.
+void Assignment::init_assignment(int num_of_vars, int max_var) {
+	int nw=(max(num_of_vars, max_var) >> 6) + 1; 	// vars are 1-indexed.
+	if(nw != num_of_words) {
+		if(words != inline_words) {
+			delete [] words;
+		}
+		words=(nw <= ASSIGN_INLINE_WORDS) ? inline_words : new uint64_t[2*nw];
+	}
+	this->num_of_vars 	=	num_of_vars;
+	this->num_of_words 	=	nw;
+	memset(words, 0, 2*num_of_words*sizeof(uint64_t));
+}
+
+void Assignment::restrict_to(const Assignment & mask) {
+	for(int w=0; w<num_of_words; ++w) {
+		words[w]&=mask.words[w];
+		words[num_of_words+w]&=mask.words[w];
+	}
+}
+
+bool Assignment::is_complete() const {
+	return get_num_assigned() == num_of_vars;
+}
+
+// a word at a time; a value bit only counts where one side assigns the var.
+int Assignment::next_diff(const Assignment & other, int var) const {
+	int nw=min(num_of_words, other.num_of_words);
+	for(int w=var >> 6; w<nw; ++w) {
+		uint64_t assigned 	=	words[w] | other.words[w];
+		uint64_t diff 		=	(words[w] ^ other.words[w]) | ((words[num_of_words+w] ^ other.words[other.num_of_words+w]) & assigned);
+		if(w == (var >> 6)) {
+			diff&=~0ULL << (var & 63);
+		}
+		if(diff) {
+			return 64*w + __builtin_ctzll(diff);
+		}
+	}
+	return 0;
+}
+
+int Assignment::get_num_assigned() const {
+	int count=0;
+	for(int w=0; w<num_of_words; ++w) {
+		count+=__builtin_popcountll(words[w]);
+	}
+	return count;
+}
+
+int Assignment::get_num_vars() const {
+	return num_of_vars;
+}
+
+size_t Assignment::get_bytes() const {
+	return sizeof(Assignment) + (words != inline_words ? 2*num_of_words*sizeof(uint64_t) : 0);
+}
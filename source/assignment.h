@@ -0,0 +1,87 @@
+#ifndef __ASSIGNMENT_H__
+#define __ASSIGNMENT_H__
+
+#include <stdint.h>
+#include <string.h>
+#include "bbdefs.h"
+
+#define ASSIGN_INLINE_WORDS 	4 		// words per mask kept inline (256 vars).
+
+
+/******************************************
+* Dense partial assignment: one bitset marks
+* which variables are assigned, a second one
+* holds their values. Both are indexed by
+* variable, so a literal is a shift-and-mask.
+******************************************/
+class Assignment {
+
+	private:
+		int num_of_vars;
+		int num_of_words;											// words per mask.
+		uint64_t * words;											// [0,nw) assigned mask, [nw,2nw) value mask.
+		uint64_t inline_words[2*ASSIGN_INLINE_WORDS];				// storage for small instances.
+
+	public:
+		Assignment();
+		Assignment(const Assignment & other);
+		Assignment(Assignment && other);
+		Assignment & operator=(const Assignment & other);
+		Assignment & operator=(Assignment && other);
+		~Assignment();
+
+		void init_assignment(int num_of_vars, int max_var=0);		// all vars unassigned; up to max_var read as unassigned.
+		void set_var(int var, bool val);							// assigns var.
+		void unset_var(int var);									// unassigns var.
+		void restrict_to(const Assignment & mask);					// unassigns vars mask leaves unassigned.
+
+		bool is_assigned(int var) const;
+		bool get_val(int var) const;
+		bool is_lit_true(int lit) const;							// lit assigned and true.
+		bool is_lit_false(int lit) const;							// lit assigned and false.
+		bool is_complete() const;									// all vars assigned.
+		int next_diff(const Assignment & other, int var) const;		// first var from var on assigned or valued differently, 0 if none.
+		int get_num_assigned() const;
+		int get_num_vars() const;
+		size_t get_bytes() const;									// footprint, heap words included.
+};
+
+
+inline void Assignment::set_var(int var, bool val) {
+	uint64_t bit=1ULL << (var & 63);
+	int w=var >> 6;
+	words[w]|=bit;
+	if(val) {
+		words[num_of_words+w]|=bit;
+	} else {
+		words[num_of_words+w]&=~bit;
+	}
+}
+
+inline void Assignment::unset_var(int var) {
+	uint64_t bit=1ULL << (var & 63);
+	int w=var >> 6;
+	words[w]&=~bit;
+	words[num_of_words+w]&=~bit;
+}
+
+inline bool Assignment::is_assigned(int var) const {
+	return (words[var >> 6] >> (var & 63)) & 1;
+}
+
+inline bool Assignment::get_val(int var) const {
+	return (words[num_of_words + (var >> 6)] >> (var & 63)) & 1;
+}
+
+inline bool Assignment::is_lit_true(int lit) const {
+	int var=lit < 0 ? -lit : lit;
+	return is_assigned(var) && (get_val(var) == (lit > 0));
+}
+
+inline bool Assignment::is_lit_false(int lit) const {
+	int var=lit < 0 ? -lit : lit;
+	return is_assigned(var) && (get_val(var) != (lit > 0));
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <thread>
+#include <fstream>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "batch.h"
+#include "instance.h"
+
+
+bool BatchRunner::init_batch(const char * path, const SolverOptions & opts, int num_jobs) {
+	this->opts 			=	opts;
+	this->opts.quiet 	=	true;
+	this->opts.progress =	false;
+	this->opts.keep_tree 	=	false;
+	this->num_jobs 		=	max(1, num_jobs);
+	files.clear();
+
+	struct stat st;
+	if(stat(path, &st) != 0) {
+		return false;
+	}
+	return S_ISDIR(st.st_mode) ? list_dir(path) : list_manifest(path);
+}
+
+// every regular, non-hidden file in dir, by name.
+bool BatchRunner::list_dir(const string & dir) {
+	DIR * d=opendir(dir.c_str());
+	if(d == NULL) {
+		return false;
+	}
+	struct dirent * ent;
+	while((ent=readdir(d)) != NULL) {
+		if(ent->d_name[0] == '.') {
+			continue;
+		}
+		string file=dir + "/" + ent->d_name;
+		struct stat st;
+		if(stat(file.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+			files.push_back(file);
+		}
+	}
+	closedir(d);
+	sort(files.begin(), files.end());
+	return true;
+}
+
+// one path per line; blank lines and '#' comments are skipped, and
+// relative paths are taken from the manifest's own directory.
+bool BatchRunner::list_manifest(const string & manifest) {
+	ifstream in(manifest.c_str());
+	if(!in) {
+		return false;
+	}
+	size_t slash=manifest.rfind('/');
+	string base=(slash == string::npos) ? "" : manifest.substr(0, slash+1);
+
+	string line;
+	while(getline(in, line)) {
+		size_t b=line.find_first_not_of(" \t\r");
+		size_t e=line.find_last_not_of(" \t\r");
+		if(b == string::npos || line[b] == '#') {
+			continue;
+		}
+		string file=line.substr(b, e-b+1);
+		files.push_back(file[0] == '/' ? file : base + file);
+	}
+	return true;
+}
+
+int BatchRunner::run(FILE * out) {
+	this->out 	=	out;
+	next_print 	=	0;
+	num_failed 	=	0;
+	next_file 	=	0;
+	BatchResult blank={false, false, STATUS_UNKNOWN, 0, 0, ""};
+	results.assign(files.size(), blank);
+
+	int n=min(num_jobs, max(1, (int)files.size()));
+	vector<thread> workers;
+	for(int w = 1; w < n; ++w) {
+		workers.push_back(thread(&BatchRunner::worker, this));
+	}
+	worker();
+	for(thread & t : workers) {
+		t.join();
+	}
+	return num_failed;
+}
+
+void BatchRunner::worker() {
+	Expression expr;
+	MS_Solver mss;
+
+	int idx;
+	while((idx=next_file++) < (int)files.size()) {
+		auto start=chrono::steady_clock::now();
+		BatchResult res={true, false, STATUS_UNKNOWN, 0, 0, ""};
+
+		InstanceInfo info;
+		if(!load_instance(files[idx].c_str(), expr, info, res.error)) {
+			res.failed=true;
+		} else {
+			mss.init_solver(std::move(expr), info.num_of_clauses, info.num_of_vars);
+			mss.set_options(opts);
+			mss.solve();
+			res.status 	=	mss.get_status();
+			res.cost 	=	mss.get_best_cost();
+			mss.cut_tree();
+		}
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+		res.seconds=elapsed.count();
+
+		lock_guard<mutex> guard(out_lock);
+		results[idx]=res;
+		print_ready();
+	}
+}
+
+// file, status, cost ("-" if none), seconds, error ("-" if none); tab separated.
+void BatchRunner::print_ready() {
+	static const char * const status_name[]={ "UNKNOWN", "SATISFIABLE", "OPTIMUM", "UNSATISFIABLE" };
+
+	for(; next_print < (int)results.size() && results[next_print].done; ++next_print) {
+		const BatchResult & res=results[next_print];
+		const char * file=files[next_print].c_str();
+		if(res.failed) {
+			++num_failed;
+			fprintf(out, "%s\tERROR\t-\t%.3f\t%s\n", file, res.seconds, res.error.c_str());
+		} else if(res.status == STATUS_OPTIMUM || res.status == STATUS_FEASIBLE) {
+			fprintf(out, "%s\t%s\t%lld\t%.3f\t-\n", file, status_name[res.status], res.cost, res.seconds);
+		} else {
+			fprintf(out, "%s\t%s\t-\t%.3f\t-\n", file, status_name[res.status], res.seconds);
+		}
+	}
+	fflush(out);
+}
@@ -0,0 +1,56 @@
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <atomic>
+#include <mutex>
+#include "bbdefs.h"
+#include "ms_solver.h"
+
+struct BatchResult {
+	bool done;
+	bool failed;			// could not be loaded; error says why.
+	SolveStatus status;
+	cost_t cost;
+	double seconds;			// load plus solve.
+	string error;
+};
+
+
+/******************************************
+* Solves many instances in one process. A 
+* fixed set of worker threads pulls the next
+* file off a shared counter; each worker owns
+* an MS_Solver that takes over each loaded
+* Expression, so nothing mutable is shared
+* but the counter and the output. Result lines come
+* out in list order as soon as every earlier
+* file is done.
+******************************************/
+class BatchRunner {
+
+	private:
+		vector<string> files;
+		SolverOptions opts;
+		int num_jobs;
+
+		vector<BatchResult> results;
+		atomic<int> next_file;
+		mutex out_lock;							// guards results, next_print and out.
+		int next_print;
+		int num_failed;
+		FILE * out;
+
+		bool list_dir(const string & dir);
+		bool list_manifest(const string & manifest);
+		void worker();
+		void print_ready();
+
+	public:
+		BatchRunner(){ num_jobs=1; next_print=0; num_failed=0; out=NULL; };
+
+		bool init_batch(const char * path, const SolverOptions & opts, int num_jobs);		// path: a directory or a manifest.
+		int run(FILE * out);					// number of files that failed to load.
+};
+
+
+#endif
@@ -10,6 +10,7 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <utility>
 #include "log.h"
 
 using namespace std;
@@ -19,6 +20,8 @@ using namespace std;
 #define OKAY 		0
 #define FAIL    		-1
 
+typedef long long cost_t;		// summed clause weights.
+
 #define THRESHOLD_T   	15
 #define MIN_THRESH 		10
 
@@ -0,0 +1,148 @@
+#include "bit_eval.h"
+
+
+void BitEval::init_eval(const Expression & expr) {
+	this->expr 	=	&expr;
+	var 		=	0;
+	active 		=	false;
+	support.clear();
+	slot_of.assign(expr.get_num_vars()+1, -1);
+}
+
+int BitEval::add_slot(int v) {
+	if(slot_of[v] < 0) {
+		slot_of[v]=(int)support.size();
+		support.push_back(v);
+	}
+	return slot_of[v];
+}
+
+// a clause holding both +var and -var sits in both occurrence lists; it is kept once.
+void BitEval::set_var(int var, const Assignment & decided, const Assignment & base) {
+	for(int v : support) {
+		slot_of[v]=-1;
+	}
+	support.clear();
+	codes.clear();
+	code_offsets.assign(1, 0);
+	weights.clear();
+	has_pos.clear();
+	has_neg.clear();
+
+	varying.clear();
+	base_assigned.clear();
+	base_value.clear();
+
+	this->var 	=	var;
+	active 		=	var >= 1 && var <= expr->get_num_vars();
+	if(!active) {
+		return;
+	}
+	add_slot(var);
+
+	for(int polarity = 0; polarity < 2; ++polarity) {
+		int count;
+		const int * occ=(polarity == 0) ? expr->get_pos_occ(var, count) : expr->get_neg_occ(var, count);
+		for(int k = 0; k < count; ++k) {
+			int c=occ[k];
+			const int * clause=expr->get_clause(c);
+			int len=expr->get_clause_len(c);
+			bool pos=false;
+			bool neg=false;
+			for(int i = 0; i < len; ++i) {
+				pos=pos || clause[i] == var;
+				neg=neg || clause[i] == -var;
+			}
+			if(polarity == 1 && pos) {
+				continue;
+			}
+			for(int i = 0; i < len; ++i) {
+				int v=abs(clause[i]);
+				if(v != var) {
+					codes.push_back(2*add_slot(v) + (clause[i] > 0 ? 1 : 0));
+				}
+			}
+			code_offsets.push_back((int)codes.size());
+			weights.push_back(expr->get_clause_weight(c));
+			has_pos.push_back(pos ? 1 : 0);
+			has_neg.push_back(neg ? 1 : 0);
+		}
+	}
+
+	base_assigned.assign(support.size(), 0);
+	base_value.assign(support.size(), 0);
+	for(int s = 0; s < (int)support.size(); ++s) {
+		int v=support[s];
+		if(decided.is_assigned(v)) {
+			varying.push_back(s);
+		} else if(base.is_assigned(v)) {
+			base_assigned[s]=~0ULL;
+			base_value[s]=base.get_val(v) ? ~0ULL : 0;
+		}
+	}
+}
+
+void BitEval::clear_batch(BitBatch & batch) const {
+	batch.assigned 	=	base_assigned;
+	batch.value 	=	base_value;
+}
+
+void BitEval::load_lane(BitBatch & batch, int lane, const Assignment & vals) const {
+	uint64_t bit=1ULL << lane;
+	for(int s : varying) {
+		int v=support[s];
+		if(vals.is_assigned(v)) {
+			batch.assigned[s]|=bit;
+			if(vals.get_val(v)) {
+				batch.value[s]|=bit;
+			}
+		}
+	}
+}
+
+// adds w to out in every lane set in mask.
+static inline void add_lanes(uint64_t mask, cost_t w, cost_t * out) {
+	while(mask) {
+		out[__builtin_ctzll(mask)]+=w;
+		mask&=mask-1;
+	}
+}
+
+// Per clause: rest is where every literal other than var is false. Before
+// the branch the clause is false where var's own literals are false too;
+// after it, where var's new value satisfies none of them. Lanes that already
+// hold var at the child's value keep their cost, as in eval_delta_neg.
+void BitEval::eval_children(const BitBatch & batch, int num_lanes, cost_t * delta_true, cost_t * delta_false) const {
+	for(int j = 0; j < num_lanes; ++j) {
+		delta_true[j] 	=	0;
+		delta_false[j] 	=	0;
+	}
+	if(!active) {
+		return;
+	}
+
+	uint64_t lanes 		=	(num_lanes == BIT_LANES) ? ~0ULL : (1ULL << num_lanes) - 1;
+	uint64_t var_true 	=	batch.assigned[0] & batch.value[0];
+	uint64_t var_false 	=	batch.assigned[0] & ~batch.value[0];
+	uint64_t move_true 	=	lanes & ~var_true;			// lanes where the true child changes var.
+	uint64_t move_false =	lanes & ~var_false;
+
+	int num_of_clauses=(int)weights.size();
+	for(int c = 0; c < num_of_clauses; ++c) {
+		uint64_t rest=~0ULL;
+		for(int i = code_offsets[c]; i < code_offsets[c+1] && rest; ++i) {
+			int s=codes[i] >> 1;
+			rest&=batch.assigned[s] & (batch.value[s] ^ (uint64_t)-(int64_t)(codes[i] & 1));
+		}
+		if(!rest) {
+			continue;
+		}
+		uint64_t old_false 	=	rest & (has_pos[c] ? var_false : ~0ULL) & (has_neg[c] ? var_true : ~0ULL);
+		uint64_t true_false =	has_pos[c] ? 0 : rest;
+		uint64_t false_false=	has_neg[c] ? 0 : rest;
+		add_lanes(true_false & ~old_false & move_true, weights[c], delta_true);
+		add_lanes(old_false & ~true_false & move_true, -weights[c], delta_true);
+		add_lanes(false_false & ~old_false & move_false, weights[c], delta_false);
+		add_lanes(old_false & ~false_false & move_false, -weights[c], delta_false);
+	}
+}
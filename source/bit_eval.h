@@ -0,0 +1,66 @@
+#ifndef __BIT_EVAL_H__
+#define __BIT_EVAL_H__
+
+#include "bbdefs.h"
+#include "expression.h"
+
+#define BIT_LANES 	64 		// assignments scored per pass, one per bit of a word.
+
+
+/******************************************
+* Bit-sliced scoring of up to 64 sibling
+* assignments at once. Lane j of each word
+* belongs to assignment j: per variable, one
+* word marks the lanes where it is assigned
+* and one the lanes where it is true. A
+* literal is then false in
+* assigned & (value ^ sign) and a clause is
+* false in the AND of its literals' words.
+*
+* set_var() gathers the clauses that hold
+* the branching variable and the variables
+* they touch, once per level; only those
+* get lane words. Siblings on a bfs level
+* differ only in the variables decided so
+* far, so the others are broadcast from one
+* node and only decided ones are loaded per
+* lane. Lane words live in a BitBatch, so
+* threads share one BitEval.
+******************************************/
+struct BitBatch {
+	vector<uint64_t> assigned;							// per slot: lanes where the var is assigned.
+	vector<uint64_t> value;								// per slot: lanes where the var is true.
+};
+
+class BitEval {
+
+	private:
+		const Expression * expr;
+		int var;										// branching var, slot 0.
+		bool active;									// var appears in the expression.
+
+		vector<int> support;							// var of each slot.
+		vector<int> slot_of;							// slot of each var, -1 if none.
+		vector<int> varying;							// slots of decided vars, loaded per lane.
+		vector<uint64_t> base_assigned;					// per slot: broadcast lanes of the rest.
+		vector<uint64_t> base_value;
+		vector<int> codes;								// other lits of each clause: slot*2 + (lit > 0).
+		vector<int> code_offsets;						// start of each clause in codes (+1 sentinel).
+		vector<cost_t> weights;							// weight of each clause.
+		vector<char> has_pos;							// clause holds +var.
+		vector<char> has_neg;							// clause holds -var.
+
+		int add_slot(int v);
+
+	public:
+		BitEval(){ expr=NULL; var=0; active=false; };
+
+		void init_eval(const Expression & expr);
+		void set_var(int var, const Assignment & decided, const Assignment & base);			// clauses to score children on.
+		void clear_batch(BitBatch & batch) const;												// every lane reads as base.
+		void load_lane(BitBatch & batch, int lane, const Assignment & vals) const;
+		void eval_children(const BitBatch & batch, int num_lanes, cost_t * delta_true, cost_t * delta_false) const;	// eval_delta_neg per lane.
+};
+
+
+#endif
@@ -0,0 +1,184 @@
+#include "bound.h"
+
+
+void LowerBound::init_bound(const Expression & expr, int num_of_vars, BoundType type) {
+	this->expr 			=	&expr;
+	this->type 			=	type;
+	this->num_of_vars 	=	num_of_vars;
+
+	int num_of_clauses=expr.get_num_clauses();
+
+	reason.assign(num_of_vars+1, -1);
+	queue.clear();
+	queue.reserve(num_of_vars);
+	qhead=0;
+	stack.assign(num_of_vars+1, 0);
+	unit_weight.assign(2*(num_of_vars+1), 0);
+	removed.assign(num_of_clauses, 0);
+	seen.assign(num_of_clauses, 0);
+	removed_stamp 	=	0;
+	seen_stamp 		=	0;
+}
+
+cost_t LowerBound::eval_bound(const Assignment & vals) {
+	switch(type) {
+		case BOUND_UNIT:
+			return eval_unit(vals);
+		case BOUND_UP:
+			return eval_up(vals);
+		default:
+			return 0;
+	}
+}
+
+// A clause with every literal false but one is a unit on that literal's var.
+// Whichever value the var takes, the units of the other polarity end up 
+// false, and units on different vars are different clauses.
+cost_t LowerBound::eval_unit(const Assignment & vals) {
+	int num_of_clauses=expr->get_num_clauses();
+
+	fill(unit_weight.begin(), unit_weight.end(), 0);
+	for(int c=0; c<num_of_clauses; ++c) {
+		const int * clause=expr->get_clause(c);
+		int len=expr->get_clause_len(c);
+		int free_lit=0;
+		int num_free=0;
+		for(int i=0; i<len && num_free<2; ++i) {
+			if(abs(clause[i]) > num_of_vars || vals.is_lit_true(clause[i])) {
+				num_free=2;
+			} else if(!vals.is_lit_false(clause[i])) {
+				free_lit=clause[i];
+				++num_free;
+			}
+		}
+		if(num_free == 1) {
+			unit_weight[2*abs(free_lit) + (free_lit > 0)]+=expr->get_clause_weight(c);
+		}
+	}
+
+	cost_t bound=0;
+	for(int var=1; var<=num_of_vars; ++var) {
+		bound+=min(unit_weight[2*var], unit_weight[2*var+1]);
+	}
+	return bound;
+}
+
+// bumps a stamp, clearing the marks if it wraps around.
+void LowerBound::next_stamp(vector<unsigned> & marks, unsigned & stamp) {
+	if(++stamp == 0) {
+		fill(marks.begin(), marks.end(), 0);
+		stamp=1;
+	}
+}
+
+// a lit on a var the search never assigns counts as true.
+int LowerBound::clause_state(int c, int & free_lit) {
+	const int * clause=expr->get_clause(c);
+	int len=expr->get_clause_len(c);
+	int num_free=0;
+	for(int i=0; i<len; ++i) {
+		if(abs(clause[i]) > num_of_vars || prop.is_lit_true(clause[i])) {
+			return -1;
+		}
+		if(!prop.is_lit_false(clause[i])) {
+			free_lit=clause[i];
+			++num_free;
+		}
+	}
+	return num_free;
+}
+
+// propagates the queue over clauses not yet removed.
+int LowerBound::propagate() {
+	while(qhead < (int)queue.size()) {
+		int var=queue[qhead++];
+		int count;
+		const int * occ=prop.get_val(var) ? expr->get_neg_occ(var, count) : expr->get_pos_occ(var, count);
+		for(int k=0; k<count; ++k) {
+			int c=occ[k];
+			if(removed[c] == removed_stamp) {
+				continue;
+			}
+			int free_lit=0;
+			int state=clause_state(c, free_lit);
+			if(state == 0) {
+				return c;
+			}
+			if(state == 1) {
+				int v=abs(free_lit);
+				prop.set_var(v, free_lit > 0);
+				reason[v]=c;
+				queue.push_back(v);
+			}
+		}
+	}
+	return -1;
+}
+
+// removes the conflict clause and every reason clause it depends on.
+cost_t LowerBound::remove_conflict(int c) {
+	cost_t lightest=expr->get_clause_weight(c);
+	next_stamp(seen, seen_stamp);
+	int top=0;
+	stack[top++]=c;
+	seen[c]=seen_stamp;
+	while(top > 0) {
+		int cur=stack[--top];
+		removed[cur]=removed_stamp;
+		lightest=min(lightest, expr->get_clause_weight(cur));
+		const int * clause=expr->get_clause(cur);
+		int len=expr->get_clause_len(cur);
+		for(int i=0; i<len; ++i) {
+			int r=reason[abs(clause[i])];
+			if(r >= 0 && seen[r] != seen_stamp) {
+				seen[r]=seen_stamp;
+				stack[top++]=r;
+			}
+		}
+	}
+	return lightest;
+}
+
+cost_t LowerBound::eval_up(const Assignment & vals) {
+	int num_of_clauses=expr->get_num_clauses();
+	cost_t bound=0;
+
+	next_stamp(removed, removed_stamp);
+	while(true) {
+		prop=vals;
+		for(int var : queue) {
+			reason[var]=-1;
+		}
+		queue.clear();
+		qhead=0;
+
+		// seed with the unit clauses of the residual formula.
+		int conflict=-1;
+		for(int c=0; c<num_of_clauses && conflict<0; ++c) {
+			if(removed[c] == removed_stamp) {
+				continue;
+			}
+			int free_lit=0;
+			int state=clause_state(c, free_lit);
+			if(state == 1) {
+				int v=abs(free_lit);
+				prop.set_var(v, free_lit > 0);
+				reason[v]=c;
+				queue.push_back(v);
+				conflict=propagate();
+			}
+		}
+
+		if(conflict < 0) {
+			break;
+		}
+		bound+=remove_conflict(conflict);
+	}
+
+	for(int var : queue) {
+		reason[var]=-1;
+	}
+	queue.clear();
+	qhead=0;
+	return bound;
+}
@@ -0,0 +1,63 @@
+#ifndef __BOUND_H__
+#define __BOUND_H__
+
+#include "bbdefs.h"
+#include "expression.h"
+
+enum BoundType { BOUND_NONE, BOUND_UNIT, BOUND_UP };
+
+
+/******************************************
+* Lower bound on the weight of clauses a
+* partial assignment will still falsify, on
+* top of the ones already false. Every search mode
+* adds eval_bound() to a node's cost before
+* comparing it against the incumbent.
+*
+* BOUND_UNIT: per var, the lighter of the
+*   +units and -units, by weight.
+* BOUND_UP:   unit propagation on the 
+*   residual formula; each conflict yields
+*   an inconsistent subset, which is removed
+*   before looking for the next one, so the
+*   subsets are disjoint and each costs at
+*   least its lightest clause.
+*
+* Vars past num_of_vars are never assigned
+* by the search, so a clause holding one can
+* never be false; both bounds skip it.
+******************************************/
+class LowerBound {
+
+	private:
+		const Expression * expr;
+		BoundType type;
+		int num_of_vars;								// vars the search assigns.
+
+		Assignment prop;								// vals plus propagated literals.
+		vector<int> reason;								// clause that implied each var.
+		vector<int> queue;								// propagated vars, in order.
+		int qhead;										// next queue entry to propagate.
+		vector<int> stack;								// conflict analysis work list.
+		vector<cost_t> unit_weight;						// per literal, for BOUND_UNIT.
+		vector<unsigned> removed;						// clause stamp: in a found subset.
+		vector<unsigned> seen;							// clause stamp: conflict analysis.
+		unsigned removed_stamp;
+		unsigned seen_stamp;
+
+		cost_t eval_unit(const Assignment & vals);
+		cost_t eval_up(const Assignment & vals);
+		int clause_state(int c, int & free_lit);		// -1 sat, else number of free lits.
+		int propagate();								// conflict clause, or -1.
+		void next_stamp(vector<unsigned> & marks, unsigned & stamp);
+		cost_t remove_conflict(int c);					// weight of the lightest clause removed.
+
+	public:
+		LowerBound(){ expr=NULL; type=BOUND_NONE; num_of_vars=0; };
+
+		void init_bound(const Expression & expr, int num_of_vars, BoundType type);
+		cost_t eval_bound(const Assignment & vals);		// extra falsified weight, at least.
+};
+
+
+#endif
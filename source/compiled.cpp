@@ -0,0 +1,169 @@
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "compiled.h"
+
+
+#define FNV_BASIS 	0xcbf29ce484222325ULL
+#define FNV_PRIME 	0x100000001b3ULL
+
+// FNV-1a over 32-bit words: the payload is all int32, so no byte loop is needed.
+static uint64_t checksum(uint64_t h, const char * data, size_t len) {
+	size_t words=len/4;
+	for(size_t i=0; i<words; ++i) {
+		uint32_t w;
+		memcpy(&w, data+4*i, 4);
+		h=(h ^ w) * FNV_PRIME;
+	}
+	return h;
+}
+
+bool CompiledInstance::is_compiled(const char * filename) {
+	FILE * fp=fopen(filename, "rb");
+	if(fp == NULL) {
+		return false;
+	}
+	char magic[8];
+	bool found=(fread(magic, 1, 8, fp) == 8 && memcmp(magic, COMPILED_MAGIC, 8) == 0);
+	fclose(fp);
+	return found;
+}
+
+static bool write_bytes(FILE * fp, const void * data, size_t len, uint64_t & h) {
+	h=checksum(h, (const char *)data, len);
+	return fwrite(data, 1, len, fp) == len;
+}
+
+bool CompiledInstance::write_file(const char * filename, const Expression & expr, int num_of_vars, int num_of_clauses, bool weighted, long long top) {
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, COMPILED_MAGIC, 8);
+	header.version 			=	COMPILED_VERSION;
+	header.endian 			=	COMPILED_ENDIAN;
+	header.num_of_vars 		=	num_of_vars;
+	header.num_of_clauses 	=	num_of_clauses;
+	header.max_var 			=	expr.num_of_vars;
+	header.weighted 		=	weighted ? 1 : 0;
+	header.top 				=	top;
+	header.num_lits 		=	(int64_t)expr.lits.size();
+	header.num_clauses 		=	(int64_t)expr.clause_len.size();
+	header.num_pos_occ 		=	(int64_t)expr.pos_occ.size();
+	header.num_neg_occ 		=	(int64_t)expr.neg_occ.size();
+
+	FILE * fp=fopen(filename, "wb");
+	if(fp == NULL) {
+		return false;
+	}
+
+	// the checksum is only known once the payload is out, so the header goes last.
+	bool ok=(fwrite(&header, sizeof(header), 1, fp) == 1);
+	uint64_t h=FNV_BASIS;
+	const vector<int> * arrays[]={ &expr.lits, &expr.offsets, &expr.clause_len,
+									&expr.pos_occ_offsets, &expr.pos_occ, &expr.neg_occ_offsets, &expr.neg_occ };
+	for(const vector<int> * a : arrays) {
+		ok=ok && write_bytes(fp, a->data(), a->size()*sizeof(int), h);
+	}
+
+	// soft weights as they are, -1 for a hard clause; hard weights are re-priced on load.
+	vector<int64_t> soft(expr.weights.begin(), expr.weights.end());
+	for(size_t c=0; c<soft.size(); ++c) {
+		if(expr.hard[c]) {
+			soft[c]=-1;
+		}
+	}
+	ok=ok && write_bytes(fp, soft.data(), soft.size()*sizeof(int64_t), h);
+
+	header.checksum=h;
+	ok=ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+	ok=(fclose(fp) == 0) && ok;
+	return ok;
+}
+
+bool CompiledInstance::load_file(const char * filename, Expression & expr) {
+	bad_input=false;
+	int fd=open(filename, O_RDONLY);
+	if(fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(header)) {
+		close(fd);
+		return false;
+	}
+	size_t size=(size_t)st.st_size;
+	void * base=mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(base == MAP_FAILED) {
+		return false;
+	}
+	madvise(base, size, MADV_SEQUENTIAL);
+
+	const char * p=(const char *)base;
+	memcpy(&header, p, sizeof(header));
+	if(memcmp(header.magic, COMPILED_MAGIC, 8) != 0) {
+		munmap(base, size);
+		return false;
+	}
+
+	int64_t C=header.num_clauses;
+	int64_t V=header.max_var;
+	int64_t counts[]={ header.num_lits, C+1, C, V+2, header.num_pos_occ, V+2, header.num_neg_occ };
+	int64_t payload=C*(int64_t)sizeof(int64_t);
+	bool sane=(header.version == COMPILED_VERSION && header.endian == COMPILED_ENDIAN && C >= 0 && C <= INT32_MAX && V >= 0);
+	for(int64_t n : counts) {
+		sane=sane && n >= 0 && n <= INT32_MAX;
+		payload+=n*(int64_t)sizeof(int);
+	}
+	sane=sane && (size_t)payload == size-sizeof(header)
+			&& checksum(FNV_BASIS, p+sizeof(header), size-sizeof(header)) == header.checksum;
+	if(!sane) {
+		munmap(base, size);
+		bad_input=true;
+		return false;
+	}
+
+	vector<int> * arrays[]={ &expr.lits, &expr.offsets, &expr.clause_len,
+							&expr.pos_occ_offsets, &expr.pos_occ, &expr.neg_occ_offsets, &expr.neg_occ };
+	const char * src=p+sizeof(header);
+	for(int i=0; i<7; ++i) {
+		arrays[i]->resize(counts[i]);
+		memcpy(arrays[i]->data(), src, counts[i]*sizeof(int));
+		src+=counts[i]*sizeof(int);
+	}
+	expr.weights.resize(C);
+	memcpy(expr.weights.data(), src, C*sizeof(int64_t));
+	expr.hard.resize(C);
+	for(int64_t c=0; c<C; ++c) {
+		expr.hard[c]=expr.weights[c] < 0;
+		if(expr.hard[c]) {
+			expr.weights[c]=0;
+		}
+	}
+	expr.num_of_vars=header.max_var;
+	expr.finish_weights();
+	expr.find_width();
+
+	munmap(base, size);
+	return true;
+}
+
+int CompiledInstance::get_num_vars() const {
+	return header.num_of_vars;
+}
+
+int CompiledInstance::get_num_clauses() const {
+	return header.num_of_clauses;
+}
+
+bool CompiledInstance::is_weighted() const {
+	return header.weighted != 0;
+}
+
+long long CompiledInstance::get_top() const {
+	return header.top;
+}
+
+bool CompiledInstance::is_bad() const {
+	return bad_input;
+}
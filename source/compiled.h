@@ -0,0 +1,60 @@
+#ifndef __COMPILED_H__
+#define __COMPILED_H__
+
+#include <stdint.h>
+#include "bbdefs.h"
+#include "expression.h"
+
+#define COMPILED_MAGIC 		"MSCNFBIN"
+#define COMPILED_VERSION 	2
+#define COMPILED_ENDIAN 	0x01020304u 		// reads back swapped on a foreign-endian host.
+
+struct CompiledHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t endian;
+	int32_t num_of_vars;			// from the text header.
+	int32_t num_of_clauses;			// from the text header.
+	int32_t max_var;				// largest variable in the clauses.
+	int32_t weighted;
+	int64_t top;
+	int64_t num_lits;
+	int64_t num_clauses;			// clauses actually stored.
+	int64_t num_pos_occ;
+	int64_t num_neg_occ;
+	uint64_t checksum;				// over everything after the header.
+};
+
+
+/******************************************
+* Binary instance cache. The file is the 
+* header above followed by Expression's own
+* arrays (lits, offsets, clause_len, both 
+* occurrence lists, then the clause weights
+* as int64 with -1 for hard), so loading is
+* a checksum pass and a bulk copy: no text 
+* to parse and no occurrence lists to build.
+******************************************/
+class CompiledInstance {
+
+	private:
+		CompiledHeader header;
+		bool bad_input;
+
+	public:
+		CompiledInstance(){ bad_input=false; };
+
+		static bool is_compiled(const char * filename);
+
+		bool write_file(const char * filename, const Expression & expr, int num_of_vars, int num_of_clauses, bool weighted, long long top);
+		bool load_file(const char * filename, Expression & expr);		// false and is_bad() on a damaged file.
+
+		int get_num_vars() const;
+		int get_num_clauses() const;
+		bool is_weighted() const;
+		long long get_top() const;
+		bool is_bad() const;
+};
+
+
+#endif
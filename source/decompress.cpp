@@ -0,0 +1,132 @@
+#include <string.h>
+#include "decompress.h"
+
+
+Decompressor::~Decompressor() {
+	end();
+}
+
+void Decompressor::end() {
+	if(!started) {
+		return;
+	}
+	if(codec == CODEC_GZIP) {
+		inflateEnd(&zs);
+	} else if(codec == CODEC_XZ) {
+		lzma_end(&xs);
+	}
+	started=false;
+}
+
+Codec Decompressor::detect(const char * data, size_t len) {
+	const unsigned char * p=(const unsigned char *)data;
+	if(len >= 2 && p[0] == 0x1f && p[1] == 0x8b) {
+		return CODEC_GZIP;
+	}
+	if(len >= 6 && memcmp(p, "\xfd" "7zXZ\0", 6) == 0) {
+		return CODEC_XZ;
+	}
+	return CODEC_PLAIN;
+}
+
+bool Decompressor::init_decompressor(Codec codec) {
+	end();
+	this->codec 	=	codec;
+	failed 			=	false;
+	at_stream_end 	=	false;
+	out.resize(DECOMPRESS_CHUNK);
+
+	if(codec == CODEC_GZIP) {
+		memset(&zs, 0, sizeof(zs));
+		started=(inflateInit2(&zs, 15+32) == Z_OK);		// 15+32: gzip or zlib header.
+	} else if(codec == CODEC_XZ) {
+		xs=LZMA_STREAM_INIT;
+		started=(lzma_stream_decoder(&xs, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK);
+	} else {
+		started=true;
+	}
+	failed=!started;
+	return started;
+}
+
+bool Decompressor::push(const char * data, size_t len, const function<void(const char *, size_t)> & sink) {
+	if(failed) {
+		return false;
+	}
+	switch(codec) {
+		case CODEC_GZIP:
+			failed=!push_gzip(data, len, sink);
+			break;
+		case CODEC_XZ:
+			failed=!push_xz(data, len, LZMA_RUN, sink);
+			break;
+		default:
+			sink(data, len);
+			break;
+	}
+	return !failed;
+}
+
+bool Decompressor::finish(const function<void(const char *, size_t)> & sink) {
+	if(failed) {
+		return false;
+	}
+	if(codec == CODEC_GZIP) {
+		failed=!at_stream_end;
+	} else if(codec == CODEC_XZ) {
+		failed=!push_xz(NULL, 0, LZMA_FINISH, sink);
+	}
+	end();
+	return !failed;
+}
+
+bool Decompressor::push_gzip(const char * data, size_t len, const function<void(const char *, size_t)> & sink) {
+	zs.next_in 	=	(Bytef *)data;
+	zs.avail_in =	(uInt)len;
+
+	while(zs.avail_in > 0) {
+		zs.next_out 	=	(Bytef *)out.data();
+		zs.avail_out 	=	(uInt)out.size();
+		int ret=inflate(&zs, Z_NO_FLUSH);
+		if(ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+			return false;
+		}
+
+		size_t have=out.size() - zs.avail_out;
+		if(have > 0) {
+			sink(out.data(), have);
+		}
+		at_stream_end=(ret == Z_STREAM_END);
+		if(at_stream_end && zs.avail_in > 0) {
+			inflateReset(&zs);					// next member of a concatenated file.
+		} else if(ret == Z_BUF_ERROR && have == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Decompressor::push_xz(const char * data, size_t len, lzma_action action, const function<void(const char *, size_t)> & sink) {
+	xs.next_in 	=	(const uint8_t *)data;
+	xs.avail_in =	len;
+
+	while(true) {
+		xs.next_out 	=	(uint8_t *)out.data();
+		xs.avail_out 	=	out.size();
+		lzma_ret ret=lzma_code(&xs, action);
+		if(ret != LZMA_OK && ret != LZMA_STREAM_END) {
+			return false;
+		}
+
+		size_t have=out.size() - xs.avail_out;
+		if(have > 0) {
+			sink(out.data(), have);
+		}
+		if(ret == LZMA_STREAM_END) {
+			return true;
+		}
+		if(xs.avail_in == 0 && xs.avail_out > 0 && action == LZMA_RUN) {
+			return true;
+		}
+	}
+}
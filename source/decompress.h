@@ -0,0 +1,49 @@
+#ifndef __DECOMPRESS_H__
+#define __DECOMPRESS_H__
+
+#include <zlib.h>
+#include <lzma.h>
+#include <functional>
+#include "bbdefs.h"
+
+#define DECOMPRESS_CHUNK 	(1 << 16) 		// bytes of plain text handed on at a time.
+
+enum Codec { CODEC_PLAIN, CODEC_GZIP, CODEC_XZ };
+
+
+/******************************************
+* Streaming gzip/xz decoder. Compressed bytes
+* go in through push() in chunks of any size,
+* and plain text comes out in DECOMPRESS_CHUNK
+* pieces to the sink, so the whole plain file
+* is never held at once. Concatenated streams
+* (pigz, xz -T) are decoded back to back.
+******************************************/
+class Decompressor {
+
+	private:
+		Codec codec;
+		z_stream zs;
+		lzma_stream xs;
+		bool started;
+		bool failed;
+		bool at_stream_end;					// last gzip member ended cleanly.
+		vector<char> out;
+
+		bool push_gzip(const char * data, size_t len, const function<void(const char *, size_t)> & sink);
+		bool push_xz(const char * data, size_t len, lzma_action action, const function<void(const char *, size_t)> & sink);
+		void end();
+
+	public:
+		Decompressor(){ codec=CODEC_PLAIN; started=false; failed=false; };
+		~Decompressor();
+
+		static Codec detect(const char * data, size_t len);
+
+		bool init_decompressor(Codec codec);
+		bool push(const char * data, size_t len, const function<void(const char *, size_t)> & sink);
+		bool finish(const function<void(const char *, size_t)> & sink);		// false on a truncated stream.
+};
+
+
+#endif
@@ -0,0 +1,261 @@
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dimacs.h"
+
+
+void DimacsParser::begin(Expression & expr) {
+	this->expr 		=	&expr;
+	state 			=	AT_LINE_START;
+	header_line.clear();
+
+	header_seen 	=	false;
+	header_ints 	=	0;
+	weighted 		=	false;
+	clause_open 	=	false;
+	want_weight 	=	false;
+	weight 			=	1;
+
+	in_num 			=	false;
+	neg 			=	false;
+	num 			=	0;
+
+	num_of_vars 	=	0;
+	num_of_clauses 	=	0;
+	top 			=	0;
+	bad_input 		=	false;
+	bytes_hint 		=	0;
+	raw_seen 		=	false;
+
+	expr.begin_expression();
+}
+
+void DimacsParser::feed(const char * data, size_t len) {
+	const char * p 		=	data;
+	const char * end 	=	data+len;
+
+	while(p < end) {
+		char c=*p++;
+		switch(state) {
+			case AT_END:
+				return;
+
+			case IN_COMMENT:
+				if(c == '\n') {
+					state=AT_LINE_START;
+				}
+				continue;
+
+			case IN_HEADER:
+				if(c == '\n') {
+					parse_header();
+					state=AT_LINE_START;
+				} else {
+					header_line+=c;
+				}
+				continue;
+
+			case AT_LINE_START:
+				if(c == 'c') {
+					state=IN_COMMENT;
+					continue;
+				}
+				if(c == 'p') {
+					header_line="p";
+					state=IN_HEADER;
+					continue;
+				}
+				if(c == '%') {
+					state=AT_END;
+					return;
+				}
+				if(c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+					continue;
+				}
+				state=IN_CLAUSES;
+				// fall through: c starts the first token on this line.
+
+			case IN_CLAUSES:
+				if(c >= '0' && c <= '9') {
+					num=num*10 + (c-'0');
+					in_num=true;
+				} else if(c == '-' && !in_num) {
+					neg=true;
+				} else {
+					if(in_num) {
+						emit(neg ? -num : num);
+					} else if(neg || !(c == ' ' || c == '\t' || c == '\r' || c == '\n')) {
+						bad_input=true;
+					}
+					in_num 	=	false;
+					neg 	=	false;
+					num 	=	0;
+					if(c == '\n') {
+						state=AT_LINE_START;
+					}
+				}
+				continue;
+		}
+	}
+}
+
+void DimacsParser::finish() {
+	if(state == IN_HEADER) {
+		parse_header();
+	}
+	if(in_num) {
+		emit(neg ? -num : num);
+		in_num=false;
+	}
+	if(clause_open) {
+		emit(0);
+	}
+	expr->end_expression();
+}
+
+void DimacsParser::parse_header() {
+	char format[16];
+	long long t=0;
+	int fields=sscanf(header_line.c_str(), "p %15s %d %d %lld", format, &num_of_vars, &num_of_clauses, &t);
+	if(fields < 3) {
+		bad_input=true;
+		return;
+	}
+	header_seen=true;
+	reserve_clauses();
+	if(strcmp(format, "wcnf") == 0) {
+		weighted 	=	true;
+		want_weight =	true;
+		top 		=	(fields == 4) ? t : 0;
+	} else if(strcmp(format, "cnf") != 0) {
+		bad_input=true;
+	}
+}
+
+// a clause takes at least two bytes ("0\n"), so a lying header can't over-reserve.
+void DimacsParser::reserve_clauses() {
+	long long hint=min((long long)num_of_clauses, (long long)(bytes_hint/2));
+	expr->reserve_clauses((int)hint);
+}
+
+void DimacsParser::emit(long long val) {
+	if(!header_seen) {
+		if(header_ints == 0) {
+			num_of_vars=(int)val;
+		} else {
+			num_of_clauses=(int)val;
+			header_seen=true;
+			reserve_clauses();
+		}
+		++header_ints;
+		return;
+	}
+	if(want_weight) {
+		weight 		=	val;
+		want_weight =	false;
+		clause_open =	true;
+		return;
+	}
+	if(val == 0) {
+		expr->end_clause(weight, weighted && top > 0 && weight >= top);
+		clause_open =	false;
+		want_weight =	weighted;
+		weight 		=	1;
+	} else {
+		expr->add_lit((int)val);
+		clause_open=true;
+	}
+}
+
+bool DimacsParser::parse_file(const char * filename, Expression & expr) {
+	bool is_stdin=(strcmp(filename, "-") == 0);
+	int fd=is_stdin ? STDIN_FILENO : open(filename, O_RDONLY);
+	if(fd < 0) {
+		return false;
+	}
+
+	begin(expr);
+	struct stat st;
+	if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		bytes_hint=(size_t)st.st_size;
+	}
+	bool ok=(bytes_hint > 0 && parse_mapped(fd, bytes_hint));
+	if(!raw_seen) {
+		ok=parse_stream(fd);
+	}
+	if(!is_stdin) {
+		close(fd);
+	}
+	if(ok && raw_seen) {
+		ok=unzip.finish([this](const char * data, size_t len) { feed(data, len); });
+	}
+	if(!ok) {
+		bad_input=true;
+	}
+	finish();
+	return ok;
+}
+
+bool DimacsParser::feed_raw(const char * data, size_t len) {
+	if(!raw_seen) {
+		raw_seen=true;
+		Codec codec=Decompressor::detect(data, len);
+		if(codec != CODEC_PLAIN) {
+			bytes_hint=0;						// compressed size says little about clause count.
+		}
+		if(!unzip.init_decompressor(codec)) {
+			return false;
+		}
+	}
+	return unzip.push(data, len, [this](const char * data, size_t len) { feed(data, len); });
+}
+
+// parse straight out of the page cache; plain files are never copied.
+bool DimacsParser::parse_mapped(int fd, size_t size) {
+	void * base=mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(base == MAP_FAILED) {
+		return false;
+	}
+	madvise(base, size, MADV_SEQUENTIAL);
+	bool ok=feed_raw((const char *)base, size);
+	munmap(base, size);
+	return ok;
+}
+
+// for pipes and anything else mmap refuses.
+bool DimacsParser::parse_stream(int fd) {
+	vector<char> buf(DIMACS_CHUNK);
+	ssize_t n;
+	while((n=read(fd, buf.data(), buf.size())) > 0) {
+		if(!feed_raw(buf.data(), (size_t)n)) {
+			return false;
+		}
+	}
+	return n == 0;
+}
+
+int DimacsParser::get_num_vars() const {
+	return num_of_vars;
+}
+
+int DimacsParser::get_num_clauses() const {
+	return num_of_clauses;
+}
+
+bool DimacsParser::is_weighted() const {
+	return weighted;
+}
+
+long long DimacsParser::get_top() const {
+	return top;
+}
+
+bool DimacsParser::is_bad() const {
+	return bad_input;
+}
+
+bool DimacsParser::has_header() const {
+	return header_seen;
+}
@@ -0,0 +1,76 @@
+#ifndef __DIMACS_H__
+#define __DIMACS_H__
+
+#include "bbdefs.h"
+#include "expression.h"
+#include "decompress.h"
+
+#define DIMACS_CHUNK 	(1 << 16) 		// bytes per read when parsing a file.
+
+
+/******************************************
+* Push parser for DIMACS text. Input is fed
+* in chunks of any size (a token may span 
+* two chunks) and clauses go straight into
+* the Expression. Understands comment lines,
+* "p cnf V C", "p wcnf V C [top]" (weight
+* >= top marks a hard clause), a '%' 
+* end marker, and the headerless "V C" 
+* first line used by the files in inputs/.
+* parse_file also takes gzip or xz input, 
+* told apart by its magic bytes.
+******************************************/
+class DimacsParser {
+
+	private:
+		enum ParseState { AT_LINE_START, IN_COMMENT, IN_HEADER, IN_CLAUSES, AT_END };
+
+		Expression * expr;
+		ParseState state;
+		string header_line;
+
+		bool header_seen;
+		int header_ints;								// ints read for a headerless "V C".
+		bool weighted;
+		bool clause_open;								// literals read since the last 0.
+		bool want_weight;								// next int is a clause weight (wcnf).
+		long long weight;
+
+		bool in_num;
+		bool neg;
+		long long num;
+
+		int num_of_vars;
+		int num_of_clauses;
+		long long top;
+		bool bad_input;
+		size_t bytes_hint;								// input size when known, else 0.
+		Decompressor unzip;
+		bool raw_seen;									// codec picked from the first raw bytes.
+
+		void parse_header();
+		void reserve_clauses();
+		void emit(long long val);
+		bool feed_raw(const char * data, size_t len);
+		bool parse_mapped(int fd, size_t size);
+		bool parse_stream(int fd);
+
+	public:
+		DimacsParser(){ expr=NULL; bad_input=false; };
+
+		void begin(Expression & expr);
+		void feed(const char * data, size_t len);
+		void finish();									// flushes a clause missing its 0.
+
+		bool parse_file(const char * filename, Expression & expr);		// plain, .gz or .xz; "-" is stdin.
+
+		int get_num_vars() const;
+		int get_num_clauses() const;
+		bool is_weighted() const;
+		long long get_top() const;						// wcnf weight of a hard clause.
+		bool is_bad() const;
+		bool has_header() const;						// a "p" line or a headerless "V C".
+};
+
+
+#endif
@@ -0,0 +1,107 @@
+/******************************************
+* Clause-kernel benchmark for Expression.
+* Scores a set of random complete
+* assignments with the generic kernel and
+* with the one picked for the instance's
+* clause width (best of a few runs each),
+* checks that they agree, and reports
+* ns/clause and the speedup.
+******************************************/
+#include <string.h>
+#include "dimacs.h"
+#include "compiled.h"
+
+#define BENCH_RUNS 		3
+#define BENCH_ASSIGNS 	256
+
+char cmd_list[]="Usage ./eval_bench [-runs N] [-assign N] file ...";
+
+// best time over runs of one kernel over every assignment; sum guards the work.
+template<typename Kernel>
+double time_kernel(const vector<Assignment> & assigns, int runs, cost_t & sum, Kernel kernel) {
+	double best=0;
+	for(int r=0; r<runs; ++r) {
+		sum=0;
+		auto start=chrono::steady_clock::now();
+		for(const Assignment & a : assigns) {
+			sum+=kernel(a);
+		}
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+		if(r == 0 || elapsed.count() < best) {
+			best=elapsed.count();
+		}
+	}
+	return best;
+}
+
+// false, with no timings, if the file does not load.
+bool bench_file(const char * path, int runs, int num_assigns) {
+	Expression expr;
+	bool loaded;
+	if(CompiledInstance::is_compiled(path)) {
+		CompiledInstance compiled;
+		loaded=compiled.load_file(path, expr);
+	} else {
+		DimacsParser parser;
+		loaded=parser.parse_file(path, expr) && !parser.is_bad() && parser.has_header();
+	}
+	if(!loaded) {
+		LOG(ERROR) << "Cannot load ["<< path<<"]";
+		return false;
+	}
+
+	int num_of_vars=expr.get_num_vars();
+	vector<Assignment> assigns(num_assigns);
+	unsigned long long x=88172645463325252ULL;
+	for(Assignment & a : assigns) {
+		a.init_assignment(num_of_vars);
+		for(int var=1; var<=num_of_vars; ++var) {
+			x^=x<<13;	x^=x>>7;	x^=x<<17;
+			a.set_var(var, (x >> 32) & 1);
+		}
+	}
+
+	cost_t generic_sum=0;
+	cost_t fixed_sum=0;
+	double generic=time_kernel(assigns, runs, generic_sum, [&](const Assignment & a) { return expr.eval_expression_neg_generic(a); });
+	double fixed=time_kernel(assigns, runs, fixed_sum, [&](const Assignment & a) { return expr.eval_expression_neg(a); });
+
+	double clauses=(double)expr.get_num_clauses()*num_assigns;
+	LOG(STATS) << path;
+	LOG(STATS) << " ~-> Clauses: "<<expr.get_num_clauses()<<", Width: "<<expr.get_clause_width()<<", Assignments: "<<num_assigns;
+	LOG(STATS) << " ~-> Generic: "<<generic*1e9/clauses<<" ns/clause";
+	LOG(STATS) << " ~-> Width-specialized: "<<fixed*1e9/clauses<<" ns/clause ("<<generic/fixed<<"x)";
+	if(generic_sum != fixed_sum) {
+		LOG(ERROR) << "Kernels disagree: "<<generic_sum<<" vs "<<fixed_sum;
+	}
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	int runs=BENCH_RUNS;
+	int num_assigns=BENCH_ASSIGNS;
+	vector<const char *> files;
+
+	for(int i=1; i<argc; ++i) {
+		if(strcmp(argv[i], "-runs") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			runs=atoi(argv[++i]);
+		} else if(strcmp(argv[i], "-assign") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			num_assigns=atoi(argv[++i]);
+		} else if(argv[i][0] == '-') {
+			printf("%s\n", cmd_list);
+			return FAIL;
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+	if(files.empty()) {
+		printf("%s\n", cmd_list);
+		return FAIL;
+	}
+
+	bool all_loaded=true;
+	for(const char * f : files) {
+		all_loaded=bench_file(f, runs, num_assigns) && all_loaded;
+	}
+	return all_loaded ? OKAY : FAIL;
+}
@@ -1,47 +1,328 @@
+#include <climits>
 #include "expression.h"
 
 
-void Expression::init_expression(vector< vector<int> > expr) {
-	expression=expr;
+void Expression::init_expression(const vector< vector<int> > & expr) {
+	int num_of_lits=0;
+	for(const vector<int> & c : expr) {
+		num_of_lits+=(int)c.size();
+	}
+
+	begin_expression();
+	lits.reserve(num_of_lits);
+	offsets.reserve(expr.size()+1);
+	clause_len.reserve(expr.size());
+	weights.reserve(expr.size());
+
+	for(const vector<int> & c : expr) {
+		for(int lit : c) {
+			add_lit(lit);
+		}
+		end_clause(1, false);
+	}
+	end_expression();
+}
+
+void Expression::begin_expression() {
+	lits.clear();
+	offsets.clear();
+	clause_len.clear();
+	weights.clear();
+	hard.clear();
+	offsets.push_back(0);
+}
+
+void Expression::reserve_clauses(int num_of_clauses) {
+	if(num_of_clauses <= 0) {
+		return;
+	}
+	offsets.reserve(num_of_clauses+1);
+	clause_len.reserve(num_of_clauses);
+	weights.reserve(num_of_clauses);
+	hard.reserve(num_of_clauses);
+}
+
+void Expression::add_lit(int lit) {
+	lits.push_back(lit);
+}
+
+// offsets always ends with the start of the open clause, which doubles as the sentinel.
+void Expression::end_clause(cost_t weight, bool is_hard) {
+	clause_len.push_back((int)lits.size() - offsets.back());
+	weights.push_back(is_hard ? 0 : weight);
+	hard.push_back(is_hard ? 1 : 0);
+	offsets.push_back((int)lits.size());
+}
+
+void Expression::end_expression() {
+	finish_weights();
+	find_width();
+	build_occ_lists();
+}
+
+// prices the hard clauses once every soft weight is known. Costs are sums
+// of clause weights, so they all fit if breaking every clause does; LLONG_MAX
+// itself stays free for "no cost yet".
+void Expression::finish_weights() {
+	int num_of_clauses=(int)clause_len.size();
+	soft_total 	=	0;
+	num_hard 	=	0;
+	weighted 	=	false;
+	costs_fit 	=	true;
+	for(int c=0; c<num_of_clauses; ++c) {
+		if(hard[c]) {
+			++num_hard;
+		} else {
+			costs_fit=!__builtin_add_overflow(soft_total, weights[c], &soft_total) && costs_fit;
+			weighted=weighted || weights[c] != 1;
+		}
+	}
+	weighted 	=	weighted || num_hard > 0;
+	cost_t all_false;
+	costs_fit 	=	!__builtin_add_overflow(soft_total, (cost_t)1, &hard_weight) && costs_fit
+					&& !__builtin_mul_overflow((cost_t)num_hard, hard_weight, &all_false)
+					&& !__builtin_add_overflow(all_false, soft_total, &all_false) && all_false < LLONG_MAX;
+	for(int c=0; c<num_of_clauses; ++c) {
+		if(hard[c]) {
+			weights[c]=hard_weight;
+		}
+	}
+}
+
+void Expression::find_width() {
+	int num_of_clauses=(int)clause_len.size();
+	clause_width=(num_of_clauses > 0) ? clause_len[0] : 0;
+	for(int c=1; c<num_of_clauses && clause_width; ++c) {
+		if(clause_len[c] != clause_width) {
+			clause_width=0;
+		}
+	}
+}
+
+void Expression::build_occ_lists() {
+	num_of_vars=0;
+	for(int lit : lits) {
+		num_of_vars=max(num_of_vars, abs(lit));
+	}
+
+	pos_occ_offsets.assign(num_of_vars+2, 0);
+	neg_occ_offsets.assign(num_of_vars+2, 0);
+
+	// count each (clause, var, polarity) once, even if a literal repeats.
+	int num_of_clauses=(int)clause_len.size();
+	vector<int> last_pos(num_of_vars+1, -1);
+	vector<int> last_neg(num_of_vars+1, -1);
+	for(int c=0; c<num_of_clauses; ++c) {
+		for(int i=offsets[c]; i<offsets[c+1]; ++i) {
+			int var=abs(lits[i]);
+			if(lits[i] > 0 && last_pos[var] != c) {
+				last_pos[var]=c;
+				pos_occ_offsets[var+1]++;
+			} else if(lits[i] < 0 && last_neg[var] != c) {
+				last_neg[var]=c;
+				neg_occ_offsets[var+1]++;
+			}
+		}
+	}
+	for(int var=1; var<=num_of_vars+1; ++var) {
+		pos_occ_offsets[var]+=pos_occ_offsets[var-1];
+		neg_occ_offsets[var]+=neg_occ_offsets[var-1];
+	}
+
+	pos_occ.resize(pos_occ_offsets[num_of_vars+1]);
+	neg_occ.resize(neg_occ_offsets[num_of_vars+1]);
+
+	vector<int> pos_fill(pos_occ_offsets.begin(), pos_occ_offsets.end()-1);
+	vector<int> neg_fill(neg_occ_offsets.begin(), neg_occ_offsets.end()-1);
+	for(int var=0; var<=num_of_vars; ++var) {
+		last_pos[var]=-1;
+		last_neg[var]=-1;
+	}
+	for(int c=0; c<num_of_clauses; ++c) {
+		for(int i=offsets[c]; i<offsets[c+1]; ++i) {
+			int var=abs(lits[i]);
+			if(lits[i] > 0 && last_pos[var] != c) {
+				last_pos[var]=c;
+				pos_occ[pos_fill[var]++]=c;
+			} else if(lits[i] < 0 && last_neg[var] != c) {
+				last_neg[var]=c;
+				neg_occ[neg_fill[var]++]=c;
+			}
+		}
+	}
+}
+
+bool Expression::is_clause_false(int c, const Assignment & vals) const {
+	const int * clause=&lits[offsets[c]];
+	for(int i=0; i<clause_len[c]; ++i) {
+		if(!vals.is_lit_false(clause[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// as above, but var reads as val regardless of vals.
+bool Expression::is_clause_false(int c, const Assignment & vals, int var, bool val) const {
+	const int * clause=&lits[offsets[c]];
+	for(int i=0; i<clause_len[c]; ++i) {
+		if(abs(clause[i]) == var) {
+			if(val == (clause[i] > 0)) {
+				return false;
+			}
+		} else if(!vals.is_lit_false(clause[i])) {
+			return false;
+		}
+	}
+	return true;
 }
 
 
-int Expression::eval_expression(unordered_map<int, bool> vals) {
+int Expression::eval_expression(const Assignment & vals) const {
 	int how_many_are_true=0;
-	for(vector<int> c : expression) {
-		for(int var : c) {
-			if(vals.count(var)>0) {
-				if(vals[var]) {
-					how_many_are_true++;
-					break;
-				} 
+	int num_of_clauses=(int)clause_len.size();
+	for(int c=0; c<num_of_clauses; ++c) {
+		const int * clause=&lits[offsets[c]];
+		for(int i=0; i<clause_len[c]; ++i) {
+			if(vals.is_lit_true(clause[i])) {
+				how_many_are_true++;
+				break;
 			}
 		}
 	}
 	return how_many_are_true;
 }
 
-int Expression::eval_expression_neg(unordered_map<int, bool> vals) {
-	int how_many_are_false=0;
-	for(vector<int> c : expression) {
+cost_t Expression::eval_expression_neg(const Assignment & vals) const {
+	switch(clause_width) {
+		case 2:
+			return eval_neg_fixed<2>(vals);
+		case 3:
+			return eval_neg_fixed<3>(vals);
+		default:
+			return eval_expression_neg_generic(vals);
+	}
+}
+
+// clause c is lits[W*c .. W*c+W); W is known here, so the literal loop 
+// unrolls and runs without a branch per literal.
+template<int W>
+cost_t Expression::eval_neg_fixed(const Assignment & vals) const {
+	cost_t how_many_are_false=0;
+	int num_of_clauses=(int)clause_len.size();
+	const int * clause=lits.data();
+	for(int c=0; c<num_of_clauses; ++c, clause+=W) {
+		bool isFalse=true;
+		for(int i=0; i<W; ++i) {
+			isFalse&=vals.is_lit_false(clause[i]);
+		}
+		if(isFalse) {
+			how_many_are_false+=weights[c];
+		}
+	}
+	return how_many_are_false;
+}
+
+cost_t Expression::eval_expression_neg_generic(const Assignment & vals) const {
+	cost_t how_many_are_false=0;
+	int num_of_clauses=(int)clause_len.size();
+	for(int c=0; c<num_of_clauses; ++c) {
+		const int * clause=&lits[offsets[c]];
 		bool isFalse=true;
-		for(int var : c) {
-			if(vals.count(var)>0) {
-				if(vals[var]) {
-					isFalse=false;
-				}
-			} else {
+		for(int i=0; i<clause_len[c]; ++i) {
+			if(!vals.is_lit_false(clause[i])) {
 				isFalse=false;
 				break;
 			}
 		}
 		if(isFalse) {
-			++how_many_are_false;
+			how_many_are_false+=weights[c];
 		}
 	}
 	return how_many_are_false;	
 }
 
-vector< vector<int> > Expression::get_vector_expression() {
-	return expression;
+// Only clauses holding var can change: the ones var now satisfies may stop
+// being false, the ones holding the opposite literal may become false.
+cost_t Expression::eval_delta_neg(const Assignment & vals, int var, bool val) const {
+	if(var > num_of_vars || (vals.is_assigned(var) && vals.get_val(var) == val)) {
+		return 0;
+	}
+
+	int sat_count, unsat_count;
+	const int * sat_occ 	=	val ? get_pos_occ(var, sat_count) : get_neg_occ(var, sat_count);
+	const int * unsat_occ 	=	val ? get_neg_occ(var, unsat_count) : get_pos_occ(var, unsat_count);
+	const int * sat_end 	=	sat_occ+sat_count;
+	const int * unsat_end 	=	unsat_occ+unsat_count;
+
+	cost_t delta=0;
+	for(; sat_occ<sat_end; ++sat_occ) {
+		if(is_clause_false(*sat_occ, vals)) {
+			delta-=weights[*sat_occ];
+		}
+	}
+	for(; unsat_occ<unsat_end; ++unsat_occ) {
+		if(is_clause_false(*unsat_occ, vals, var, val)) {
+			delta+=weights[*unsat_occ];
+		}
+	}
+	return delta;
+}
+
+int Expression::get_num_clauses() const {
+	return (int)clause_len.size();
+}
+
+int Expression::get_num_lits() const {
+	return (int)lits.size();
+}
+
+int Expression::get_clause_width() const {
+	return clause_width;
+}
+
+const int * Expression::get_clause(int c) const {
+	return lits.data()+offsets[c];
+}
+
+int Expression::get_clause_len(int c) const {
+	return clause_len[c];
+}
+
+cost_t Expression::get_clause_weight(int c) const {
+	return weights[c];
+}
+
+bool Expression::is_hard(int c) const {
+	return hard[c] != 0;
+}
+
+int Expression::get_num_hard() const {
+	return num_hard;
+}
+
+cost_t Expression::get_hard_weight() const {
+	return hard_weight;
+}
+
+bool Expression::is_weighted() const {
+	return weighted;
+}
+
+bool Expression::fits_cost() const {
+	return costs_fit;
+}
+
+int Expression::get_num_vars() const {
+	return num_of_vars;
+}
+
+const int * Expression::get_pos_occ(int var, int & count) const {
+	count=pos_occ_offsets[var+1]-pos_occ_offsets[var];
+	return pos_occ.data()+pos_occ_offsets[var];
+}
+
+const int * Expression::get_neg_occ(int var, int & count) const {
+	count=neg_occ_offsets[var+1]-neg_occ_offsets[var];
+	return neg_occ.data()+neg_occ_offsets[var];
 }
\ No newline at end of file
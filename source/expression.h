@@ -2,18 +2,85 @@
 #define __EXPRESSION_H__
 
 #include "bbdefs.h"
+#include "assignment.h"
 
 
+/******************************************
+* Clauses are held in a compressed-sparse-row
+* layout: every literal lives in one array, 
+* and offsets[c] .. offsets[c+1] is clause c.
+* Occurrence lists (also CSR, per variable 
+* and polarity) name the clauses a variable 
+* touches, for incremental evaluation.
+*
+* Costs are summed weights of false clauses.
+* A hard clause weighs one more than all soft
+* clauses together, so any assignment that
+* breaks a hard clause costs at least 
+* get_hard_weight() and loses to every 
+* assignment that keeps them all.
+*
+* When every clause has the same length
+* (2 or 3), lits is a packed array of 
+* fixed-width clauses and full evaluation
+* runs a kernel compiled for that width.
+******************************************/
 class Expression {
 
+	friend class CompiledInstance;										// saves and loads the arrays below as they are.
+
 	private:
-		vector< vector<int> > expression;
+		vector<int> lits;																	// literals of all clauses, back to back.
+		vector<int> offsets;																// start of each clause in lits (+1 sentinel).
+		vector<int> clause_len;																// number of literals per clause.
+		vector<cost_t> weights;																// weight per clause (hard_weight if hard).
+		vector<char> hard;																	// 1 for a hard clause.
+		cost_t hard_weight;																	// soft_total+1.
+		cost_t soft_total;																	// sum of soft weights.
+		int num_hard;
+		bool weighted;																		// some weight other than 1, or a hard clause.
+		bool costs_fit;																		// breaking every clause costs less than LLONG_MAX.
+		int clause_width;																	// length of every clause, 0 if they differ.
+
+		int num_of_vars;																	// largest variable seen.
+		vector<int> pos_occ;																// clauses holding +var, grouped by var.
+		vector<int> pos_occ_offsets;														// start of each var in pos_occ (+1 sentinel).
+		vector<int> neg_occ;																// clauses holding -var, grouped by var.
+		vector<int> neg_occ_offsets;														// start of each var in neg_occ (+1 sentinel).
+
+		void build_occ_lists();
+		void finish_weights();
+		void find_width();
+		template<int W> cost_t eval_neg_fixed(const Assignment & vals) const;
+		bool is_clause_false(int c, const Assignment & vals) const;
+		bool is_clause_false(int c, const Assignment & vals, int var, bool val) const;
 	public:
-		Expression(){};																		//to instantiate empty object;
-		void init_expression(vector< vector<int> > expr);									//to add clauses
-		int eval_expression(unordered_map<int, bool> vars);									//to eval the clauses.
-		int eval_expression_neg(unordered_map<int, bool> vals);								//to eval the clauses (get negs)
-		vector< vector<int> > get_vector_expression();										// get vec expression;
+		Expression(){ num_of_vars=0; hard_weight=1; soft_total=0; num_hard=0; weighted=false; costs_fit=true; clause_width=0; };														//to instantiate empty object;
+		void init_expression(const vector< vector<int> > & expr);							//to add clauses
+		void begin_expression();															// start an empty expression for add_lit/end_clause.
+		void reserve_clauses(int num_of_clauses);											// size hint from a file header.
+		void add_lit(int lit);																// append a literal to the open clause.
+		void end_clause(cost_t weight, bool is_hard);										// close the open clause.
+		void end_expression();																// done adding clauses.
+		int eval_expression(const Assignment & vals) const;									//to eval the clauses (count true ones).
+		cost_t eval_expression_neg(const Assignment & vals) const;							//to eval the clauses (weight of negs)
+		cost_t eval_expression_neg_generic(const Assignment & vals) const;					// same, for any clause lengths.
+		cost_t eval_delta_neg(const Assignment & vals, int var, bool val) const;			//change in negs if var is set to val.
+
+		int get_num_clauses() const;														// number of clauses held.
+		int get_num_lits() const;															// number of literals held.
+		int get_clause_width() const;														// length of every clause, 0 if they differ.
+		const int * get_clause(int c) const;												// first literal of clause c.
+		int get_clause_len(int c) const;													// length of clause c.
+		cost_t get_clause_weight(int c) const;												// weight of clause c.
+		bool is_hard(int c) const;															// clause c must be satisfied.
+		int get_num_hard() const;															// number of hard clauses.
+		cost_t get_hard_weight() const;														// cost of breaking one hard clause.
+		bool is_weighted() const;															// not plain unit-weight MAX-SAT.
+		bool fits_cost() const;																// every sum of clause weights fits in cost_t.
+		int get_num_vars() const;															// largest variable seen.
+		const int * get_pos_occ(int var, int & count) const;								// clauses holding +var.
+		const int * get_neg_occ(int var, int & count) const;								// clauses holding -var.
 };
 
 
@@ -4,7 +4,7 @@
 
 #ifdef WIN32
 	#include "windows.h"
-#else
+#elif !defined(NO_GRAPHICS)
 	#ifndef X11
 	#define X11
 	#endif
@@ -39,8 +39,10 @@
 typedef struct {
 #ifdef X11
 	Window mainwnd; 
-#else
+#elif defined(WIN32)
 	HWND mainwnd;
+#else
+	void * mainwnd;
 #endif
 	float xmult, ymult;
 	float ps_xmult, ps_ymult;
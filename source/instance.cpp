@@ -0,0 +1,60 @@
+#include <string.h>
+#include <unistd.h>
+#include "instance.h"
+#include "dimacs.h"
+#include "compiled.h"
+
+
+bool load_instance(const char * filename, Expression & expr, InstanceInfo & info, string & error) {
+	LOG(INFO) << "Attempting to open file ["<< filename<<"]";
+
+	if(CompiledInstance::is_compiled(filename)) {
+		CompiledInstance compiled;
+		if(!compiled.load_file(filename, expr)) {
+			error=compiled.is_bad() ? "Compiled file is damaged or from another version; recompile it." : "Compiled file cannot be read.";
+			return false;
+		}
+		info.num_of_vars 		=	compiled.get_num_vars();
+		info.num_of_clauses 	=	compiled.get_num_clauses();
+		info.weighted 			=	compiled.is_weighted();
+		info.top 				=	compiled.get_top();
+	} else {
+		DimacsParser parser;
+		if(!parser.parse_file(filename, expr)) {
+			error=parser.is_bad() ? "File is truncated or corrupt." : "File does not exist.";
+			return false;
+		}
+		if(parser.is_bad()) {
+			error="File has malformed tokens; it is not a DIMACS instance.";
+			return false;
+		}
+		if(!parser.has_header()) {
+			error="File has no DIMACS header.";
+			return false;
+		}
+		info.num_of_vars 		=	parser.get_num_vars();
+		info.num_of_clauses 	=	parser.get_num_clauses();
+		info.weighted 			=	parser.is_weighted();
+		info.top 				=	parser.get_top();
+	}
+
+	if(!expr.fits_cost()) {
+		error="Clause weights are too large: breaking every clause would overflow a 64-bit cost.";
+		return false;
+	}
+
+	LOG(INFO) << "Number of variables:   --> ["<<info.num_of_vars<<"]";
+	LOG(INFO) << "Number of clauses:     --> ["<<info.num_of_clauses<<"]";
+	if(expr.get_num_clauses() != info.num_of_clauses) {
+		LOG(WARNING) << "Header promises "<<info.num_of_clauses<<" clauses, read "<<expr.get_num_clauses();
+	}
+	return true;
+}
+
+string resolve_path(const char * name) {
+	string file=name;
+	if(file != "-" && file.find('/') == string::npos && access(file.c_str(), F_OK) != 0) {
+		file="../inputs/" + file;
+	}
+	return file;
+}
@@ -0,0 +1,22 @@
+#ifndef __INSTANCE_H__
+#define __INSTANCE_H__
+
+#include "bbdefs.h"
+#include "expression.h"
+
+struct InstanceInfo {
+	int num_of_vars;		// from the file header.
+	int num_of_clauses;		// from the file header.
+	bool weighted;
+	long long top;
+};
+
+// fills expr from a text (plain, gz, xz) or compiled instance. On failure
+// returns false and says why in error; touches nothing outside its args.
+bool load_instance(const char * filename, Expression & expr, InstanceInfo & info, string & error);
+
+// paths are taken as given; a bare name not found here is looked up in ../inputs/.
+string resolve_path(const char * name);
+
+
+#endif
@@ -1,21 +1,49 @@
 #include <algorithm>
+#include <queue>
+#include <climits>
 #include "ms_solver.h"
+#include "alloc_stats.h"
 
 //~ Helper Function:
 
 
-void MS_Solver::init_solver(Expression expr, int num_of_clauses, int num_of_vars) {
+void MS_Solver::init_solver(Expression && expr, int num_of_clauses, int num_of_vars) {
 	this->num_of_clauses=num_of_clauses;	//number of clauses
 	this->num_of_vars=num_of_vars;			//number of vars;
+	this->max_var=max(num_of_vars, expr.get_num_vars());
 	this->is_opt=false;
+	this->mode=MODE_BFS;
+	this->mem_cap=DEFAULT_MEM_CAP;
+	this->bound_type=BOUND_NONE;
+	this->order_type=ORDER_START;
+	this->num_threads=1;
+	this->quiet=false;
+	this->time_limit=0;
+	this->node_limit=0;
+	this->mem_limit=0;
+	this->progress=false;
+	this->keep_tree=true;
 
 	lb=0;
 
-	this->expr=expr;
+	this->expr=std::move(expr);
+}
 
-	for(int i=1; i<=num_of_vars; ++i) {
-		vars_used_map[i]  = false;
+void MS_Solver::set_options(const SolverOptions & opts) {
+	set_optimal(opts.is_opt);
+	set_mode(opts.mode);
+	set_mem_cap(opts.mem_cap);
+	if(opts.bound_type < 0) {
+		set_bound((opts.mode == MODE_BFS) ? BOUND_NONE : BOUND_UP);
+	} else {
+		set_bound((BoundType)opts.bound_type);
 	}
+	set_order(opts.order_type);
+	set_threads(opts.num_threads);
+	set_quiet(opts.quiet);
+	set_limits(opts.time_limit, opts.node_limit, opts.mem_limit);
+	set_progress(opts.progress);
+	set_keep_tree(opts.keep_tree);
 }
 
 void MS_Solver::set_optimal(bool is_opt) {
@@ -23,38 +51,166 @@ void MS_Solver::set_optimal(bool is_opt) {
 	LOG(INFO) << " ~ Running with Optimization: "<<this->is_opt;
 }
 
-int MS_Solver::select_start() {
-	int cur_lb 		= 	10000;
-	int index 		=	1;				//default case;
-	unordered_map<int, bool> curr_soln;
+void MS_Solver::set_mode(SearchMode mode) {
+	this->mode=mode;
+}
 
-	for(int i = 1; i<=num_of_vars; ++i) {
-		curr_soln[i]=true;
-		curr_soln[-i]=false;
+void MS_Solver::set_mem_cap(size_t mem_cap) {
+	this->mem_cap=mem_cap;
+}
+
+void MS_Solver::set_bound(BoundType bound_type) {
+	this->bound_type=bound_type;
+}
+
+void MS_Solver::set_order(OrderType order_type) {
+	this->order_type=order_type;
+}
+
+void MS_Solver::set_threads(int num_threads) {
+	this->num_threads=num_threads;
+}
+
+void MS_Solver::set_quiet(bool quiet) {
+	this->quiet=quiet;
+}
+
+void MS_Solver::set_limits(double time_limit, unsigned long long node_limit, size_t mem_limit) {
+	this->time_limit=time_limit;
+	this->node_limit=node_limit;
+	this->mem_limit=mem_limit;
+}
+
+void MS_Solver::set_progress(bool progress) {
+	this->progress=progress;
+}
+
+void MS_Solver::set_keep_tree(bool keep_tree) {
+	this->keep_tree=keep_tree;
+}
+
+// true once any limit is used up; bytes is what the caller's search holds.
+bool MS_Solver::budget_spent(size_t bytes) {
+	if(stopped) {
+		return true;
+	}
+	const char * reason=NULL;
+	if(node_limit > 0 && nodes_visited >= node_limit) {
+		reason="node";
+	} else if(mem_limit > 0 && bytes >= mem_limit) {
+		reason="memory";
+	} else if(time_limit > 0) {
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-search_start;
+		if(elapsed.count() >= time_limit) {
+			reason="time";
+		}
+	}
+	if(reason != NULL) {
+		stopped=true;
+		LOG(WARNING) << " ~ The "<<reason<<" limit ran out; returning the best assignment found.";
 	}
+	return stopped;
+}
 
-	LOG(INFO) << "~ Selecting Start ~";
-	for(int i = 1 ; i<=num_of_vars; ++i) {
-		unordered_map<int, bool> var_to_bool_map=curr_soln;
+// keeps soln if it beats the incumbent, and says so on stdout if asked.
+void MS_Solver::offer_incumbent(const Assignment & soln, cost_t cost) {
+	if(cost >= best_cost) {
+		return;
+	}
+	best_soln 	=	soln;
+	best_cost 	=	cost;
+	ub 			=	min(ub, cost);
+	LOG(INFO) << " ~ Improved Upper Bound: "<<cost;
+	if(progress && cost < hard_weight) {
+		printf("o %lld\n", cost);
+		fflush(stdout);
+		printed_cost=cost;
+	}
+}
 
-		var_to_bool_map[i]	=	true;
-		var_to_bool_map[-i]	=	false;
+// sets every free var to its cheaper value, in index order; returns the new cost.
+cost_t MS_Solver::complete_greedy(Assignment & soln, cost_t cost) {
+	for(int var = 1; var <= num_of_vars; ++var) {
+		if(soln.is_assigned(var)) {
+			continue;
+		}
+		cost_t delta_true 	=	expr.eval_delta_neg(soln, var, true);
+		cost_t delta_false 	=	expr.eval_delta_neg(soln, var, false);
+		soln.set_var(var, delta_true <= delta_false);
+		cost+=min(delta_true, delta_false);
+	}
+	return cost;
+}
 
-		if(expr.eval_expression_neg(var_to_bool_map)<cur_lb) {
-			cur_lb=expr.eval_expression_neg(var_to_bool_map);
-			index=i;
+void MS_Solver::print_soln(const Assignment & soln) {
+	if(quiet) {
+		return;
+	}
+	for(int var = 1; var <= num_of_vars; ++var) {
+		if(soln.is_assigned(var)){
+			if(soln.get_val(var)) {
+				printf("Var [%d] = TRUE\n", var);
+			} else {
+				printf("Var [%d] = FALSE\n", var);
+			}
 		}
+	}
+}
 
-		var_to_bool_map[i]	=	false;
-		var_to_bool_map[-i]	=	true;
+// Picks the var whose flip to false lowers the cost of the all-true
+// assignment most (the first on ties, var 1 if no flip helps). One sweep
+// over the clauses prices every flip at once: a clause false under
+// all-true turns true when any of its vars flips, and a true clause turns
+// false only when its one positive var flips and it lacks that var's
+// negation. Vars past num_of_vars stay unassigned, so their clauses never
+// turn false.
+int MS_Solver::select_start() {
+	int index 		=	1;				//default case;
+	cost_t base 	=	0;				// cost of all-true.
+	vector<cost_t> delta(num_of_vars+1, 0);
+	vector<int> seen(num_of_vars+1, -1);		// last clause that charged each var.
+
+	LOG(INFO) << "~ Selecting Start ~";
+	int num_of_clauses=expr.get_num_clauses();
+	for(int c = 0; c < num_of_clauses; ++c) {
+		const int * clause=expr.get_clause(c);
+		int len=expr.get_clause_len(c);
+		int pos_var=0;
+		bool fixed=false;			// another true literal keeps the clause true.
+		for(int i = 0; i < len && !fixed; ++i) {
+			if(abs(clause[i]) > num_of_vars || (clause[i] > 0 && pos_var != 0 && clause[i] != pos_var)) {
+				fixed=true;
+			} else if(clause[i] > 0) {
+				pos_var=clause[i];
+			}
+		}
+		if(fixed) {
+			continue;
+		}
+
+		cost_t w=expr.get_clause_weight(c);
+		if(pos_var == 0) {
+			base+=w;
+			for(int i = 0; i < len; ++i) {
+				if(seen[-clause[i]] != c) {
+					seen[-clause[i]]=c;
+					delta[-clause[i]]-=w;
+				}
+			}
+		} else if(find(clause, clause+len, -pos_var) == clause+len) {
+			delta[pos_var]+=w;
+		}
+	}
 
-		if(expr.eval_expression_neg(var_to_bool_map)<cur_lb) {
-			cur_lb=expr.eval_expression_neg(var_to_bool_map);
-			index=i;
+	cost_t best=0;
+	for(int var = 1; var <= num_of_vars; ++var) {
+		if(delta[var] < best) {
+			best=delta[var];
+			index=var;
 		}
 	}
 
-	lb=cur_lb;
+	lb=(num_of_vars > 0) ? base+best : LLONG_MAX;
 
 	LOG(INFO) << "~ * + Found";
 	LOG(INFO) << "    |--Lower Bound: ["<<lb<<"]";
@@ -64,34 +220,22 @@ int MS_Solver::select_start() {
 
 
 
-double compute_variance(vector< vector<int> > clauses, int num_of_vars) {
-	unordered_map<int, int> var_count;
-	for(vector<int> clause : clauses) {
-		for(int var: clause) {
-			if(var < 0) {
-				int tvar=var*-1;
-				if(var_count.count(tvar)>0) {
-					var_count[tvar]++;
-				} else {
-					var_count[tvar]=1;
-				}
-			} else {
-				if(var_count.count(var)>0) {
-					var_count[var]++;
-				} else {
-					var_count[var]=1;
-				}
-			}
+double compute_variance(Expression & expr, int num_of_vars) {
+	vector<int> var_count(num_of_vars+1, 0);
+	const int * lits=expr.get_clause(0);
+	for(int i = 0; i < expr.get_num_lits(); ++i) {
+		if(abs(lits[i]) <= num_of_vars) {
+			var_count[abs(lits[i])]++;
 		}
 	}
 	double avg=0;
-	for(const auto& key : var_count) {
-		avg+=key.second;
+	for(int var = 1; var <= num_of_vars; ++var) {
+		avg+=var_count[var];
 	}
 	avg=avg/num_of_vars;
 	double variance=0;
-	for(const auto& key : var_count) {
-		variance+=pow(key.second,2);
+	for(int var = 1; var <= num_of_vars; ++var) {
+		variance+=pow(var_count[var],2);
 	}	
 	variance=variance/num_of_vars - avg;
 	return pow(variance, 0.5);
@@ -100,10 +244,33 @@ double compute_variance(vector< vector<int> > clauses, int num_of_vars) {
 
 
 void MS_Solver::solve() {
+	bound.init_bound(expr, num_of_vars, bound_type);
+	bound_prunes 	=	0;
+	nodes_visited 	=	0;
+	stopped 		=	false;
+	search_start 	=	chrono::steady_clock::now();
+	hard_weight 	=	expr.get_hard_weight();
+	best_cost 		=	LLONG_MAX;
+	printed_cost 	=	LLONG_MAX;
+	ub 				=	LLONG_MAX;
+
+	switch(mode) {
+		case MODE_DFS:
+			solve_dfs();
+			break;
+		case MODE_BEST_FIRST:
+			solve_best_first();
+			break;
+		default:
+			solve_bfs();
+			break;
+	}
+}
+
+void MS_Solver::solve_bfs() {
 	bool searching			=	true;		// signifies if we can finish exploring the tree.
 	bool high_variance		=	false;
 	int cur_lvl				=	0; 			// holds the current level during exploration.
-	int cur_uid 			= 	1; 			// holder for unique id per node.
 	int NODES_REQ			= 	16384;		// Number of Same nodes per level.
 
 	float y_pos 			= 	0;
@@ -114,7 +281,7 @@ void MS_Solver::solve() {
 
 	auto start = std::chrono::system_clock::now();	// starting timer.
 
-	double variance = compute_variance(expr.get_vector_expression(), num_of_vars);
+	double variance = compute_variance(expr, num_of_vars);
 	LOG(STATS) << "Standard Deviation: " << variance;
 
 	if((double)variance/num_of_vars < 0.5) {
@@ -127,52 +294,100 @@ void MS_Solver::solve() {
 	LOG(STATS) << " * Initializing Timer *";
 
 	LOG(INFO) << " ~ THRESHOLD: "<< THRESHOLD;
-	vector< vector<Node *> > tree;	
+	vector<TreeLevel> tree;	
 
-	unordered_map<int, int>	id_per_lvls;
-	unordered_map<int, int> uid_per_lvls;
+	Assignment curr_soln;
+	Assignment empty_soln;
 
-	int head_id=select_start();
+	curr_soln.init_assignment(num_of_vars, max_var);
+	empty_soln.init_assignment(num_of_vars, max_var);
+	for(int i = 1; i<=num_of_vars; ++i) {
+		curr_soln.set_var(i, true);
+	}
 
+	init_order();
+	int head_id=var_order.pick_var(0, empty_soln);
 
-	Node * HEAD 	= 	new Node;
 
-	unordered_map<int, bool> curr_soln;
+	tree_t.clear();
 
-	for(int i = 1; i<=num_of_vars; ++i) {
-		curr_soln[i]=true;
-		curr_soln[-i]=false;
-	}
+	// nodes hold only their decision; lvl_soln[i] is the assignment of 
+	// node i of tree[cur_lvl], and next_soln fills in as the next level is built.
+	vector<Assignment> lvl_soln(1);
+	vector<Assignment> next_soln;
+	size_t peak_frontier=0;
 
-	HEAD->init_node(NULL, head_id, cur_uid++,false);
+	lb=expr.eval_expression_neg(curr_soln);
 	if(!high_variance){
-		HEAD->add_var_to_soln(curr_soln);
+		lvl_soln[0]=std::move(curr_soln);
+	} else {
+		lvl_soln[0]=std::move(empty_soln);
 	}
-	lb=expr.eval_expression_neg(curr_soln);
-	HEAD->set_pos(x_pos, y_pos);
+	size_t soln_bytes=lvl_soln[0].get_bytes();
+
+	tree.resize(1);
+	tree[0].init_level(head_id, 1);
+	tree[0].set_node(0, -1, false, expr.eval_expression_neg(lvl_soln[0]), x_pos, y_pos);
+	size_t tree_bytes=tree[0].get_bytes();
+	size_t peak_tree=tree_bytes;
 	y_pos+=50;
 
+	vector<cost_t> child_cost;					// per node: true child, false child.
+	vector<ChildPlan> plan;						// children that survive, in order.
+	Assignment decided;							// vars branched on so far.
+	decided.init_assignment(num_of_vars, max_var);
+
+	// every node holds a complete assignment here, so lb is a cost some 
+	// node achieves, and a child whose bound exceeds it can be cut.
+	bool use_bound=bound_type != BOUND_NONE && !high_variance;
+	int lvl_id=head_id;							// var the current level branches on.
 
-	vector<Node *> root;
-	root.push_back(HEAD);
-	tree.push_back(root);
-	vars_used_map[head_id]=true;
+	bit_eval.init_eval(expr);
+	pool.init_pool(num_threads);
+	LOG(STATS) << " ~ Threads: "<<pool.get_num_threads();
+	unsigned long long allocs_start=get_alloc_count();
 
+	Assignment greedy;							// scratch for the anytime incumbent.
 	while(searching) {
-		vector<Node *> next_lvl;
+		TreeLevel next_lvl;
 		int next_id=0;
-		int cost;
 		bool should_red=true;
 
-		for(const auto& key : vars_used_map) {
-			if(!key.second) {
-				next_id=key.first;
-				break;
+		const cost_t * costs=tree[cur_lvl].get_costs();
+		int rep=tree[cur_lvl].get_size() == 0 ? -1 : 0;
+		for(int i = 1; i < tree[cur_lvl].get_size(); ++i) {
+			if(costs[i] < costs[rep]) {
+				rep=i;
 			}
 		}
 
-		id_per_lvls[cur_lvl]=next_id;
-		uid_per_lvls[cur_lvl]=cur_uid;
+		// anytime: the cheapest node here, completed greedily, is an answer to fall back on.
+		if(rep >= 0) {
+			if(lvl_soln[rep].is_complete()) {
+				offer_incumbent(lvl_soln[rep], costs[rep]);
+			} else {
+				greedy=lvl_soln[rep];
+				offer_incumbent(greedy, complete_greedy(greedy, costs[rep]));
+			}
+		}
+		size_t frontier_bytes=(lvl_soln.size()+next_soln.size())*soln_bytes;
+		peak_frontier=max(peak_frontier, frontier_bytes);
+		if(cur_lvl < num_of_vars && budget_spent(tree_bytes+frontier_bytes)) {
+			break;
+		}
+
+		decided.set_var(lvl_id, true);
+		if(var_order.is_dynamic() && rep >= 0) {
+			// score against the decided part of the cheapest node on this level.
+			partial=lvl_soln[rep];
+			partial.restrict_to(decided);
+			if(!partial.is_assigned(lvl_id)) {
+				partial.set_var(lvl_id, true);		// decided by the children, not rep.
+			}
+			next_id=var_order.pick_var(cur_lvl+1, partial);
+		} else {
+			next_id=var_order.get_var(cur_lvl+1);
+		}
 
 		if(cur_lvl<num_of_vars) {
 			if(cur_lvl<=THRESHOLD) {
@@ -181,113 +396,100 @@ void MS_Solver::solve() {
 				LOG(INFO) << " ~ * Burning Tree    @ LVL-"<<cur_lvl;
 			}
 
-			int old_cost=lb;
-			for(Node * n: tree[cur_lvl]) {
-				unordered_map<int, bool> var_map=n->get_soln();
-				var_map[n->get_id()]=true;
-				var_map[-n->get_id()]=false;
-				cost = expr.eval_expression_neg(var_map);
-				if(cost < lb) {
-					lb=cost;
+			const TreeLevel & lvl=tree[cur_lvl];
+			int lvl_size=lvl.get_size();
+			nodes_visited+=lvl_size;
+
+			// score both children of every node, one slice of the level per thread,
+			// BIT_LANES nodes per pass over the clauses holding lvl_id. Nodes only
+			// differ in decided vars, so lvl[0] stands in for the rest.
+			child_cost.resize(2*lvl_size);
+			if(lvl_size > 0) {
+				bit_eval.set_var(lvl_id, decided, lvl_soln[0]);
+			}
+			pool.parallel_for(lvl_size, [&](int begin, int end) {
+				BitBatch batch;
+				cost_t delta_true[BIT_LANES];
+				cost_t delta_false[BIT_LANES];
+				for(int i = begin; i < end; i += BIT_LANES) {
+					int num_lanes=min(BIT_LANES, end-i);
+					bit_eval.clear_batch(batch);
+					for(int j = 0; j < num_lanes; ++j) {
+						bit_eval.load_lane(batch, j, lvl_soln[i+j]);
+					}
+					bit_eval.eval_children(batch, num_lanes, delta_true, delta_false);
+					for(int j = 0; j < num_lanes; ++j) {
+						child_cost[2*(i+j)] 	=	lvl.get_cost(i+j) + delta_true[j];
+						child_cost[2*(i+j)+1] 	=	lvl.get_cost(i+j) + delta_false[j];
+					}
 				}
-					
-		
+			});
 
-				var_map=n->get_soln();
-				var_map[-n->get_id()]=true;
-				var_map[n->get_id()]=false;
-				cost = expr.eval_expression_neg(var_map);
+			cost_t old_cost=lb;
+			for(cost_t cost : child_cost) {
 				if(cost < lb) {
 					lb=cost;
 				}
-
 			}
 			if(old_cost==lb) {
 				should_red=false;
 			}
 
-			for(Node * n: tree[cur_lvl]) {
-				
-				float x_pos_t = n->get_x();
-
-				unordered_map<int, bool> var_map=n->get_soln();
-				
-				var_map[-(n->get_id())]=false;
-				var_map[n->get_id()]=true;
-				cost = expr.eval_expression_neg(var_map);
-
-				Node * right_child = new Node;
-
-				if(cur_lvl<=THRESHOLD || (cost <= lb && (int) next_lvl.size() <=NODES_REQ)) {				
-					right_child->init_node(n, next_id, cur_uid++, true);
-					right_child->add_var_to_soln(var_map);
-					right_child->set_pos(x_pos_t+x_incr, y_pos);					
-					n->set_rh_child(right_child);
-					next_lvl.push_back(right_child);
-				}
-
-				var_map=n->get_soln();
-
-				var_map[n->get_id()]=false;
-				var_map[-(n->get_id())]=true;
-				cost = expr.eval_expression_neg(var_map);
-				
-				Node * left_child = new Node;
-
-				if( cur_lvl<=THRESHOLD || (cost <= lb && (int) next_lvl.size() <=NODES_REQ)) {
-					left_child->init_node(n, next_id, cur_uid++, false);
-					left_child->add_var_to_soln(var_map);
-					left_child->set_pos(x_pos_t-x_incr, y_pos);					
-					n->set_lh_child(left_child);
-					next_lvl.push_back(left_child);
+			// once some child keeps every hard clause, children that break one are dropped.
+			cost_t cutoff=(lb < hard_weight) ? hard_weight : LLONG_MAX;
+
+			// survivors are picked serially in node order, so NODES_REQ and uids 
+			// come out the same for any thread count.
+			plan.clear();
+			for(int i = 0; i < lvl_size; ++i) {
+				for(int b = 0; b < 2; ++b) {
+					cost_t cost=child_cost[2*i+b];
+					if(cost < cutoff && (cur_lvl<=THRESHOLD || (cost <= lb && (int) plan.size() <=NODES_REQ)) && !(use_bound && bfs_bound_cuts(lvl_soln[i], lvl.get_var(), b == 0, decided, lb))) {
+						ChildPlan p={cost, i, b == 0};
+						plan.push_back(p);
+					}
 				}
 			}
 			if( (high_variance || !is_opt) && cur_lvl>=THRESHOLD) {
 				LOG(INFO) << "..-* [done]";
-				for(Node * n: tree[cur_lvl]) {
-
-					float x_pos_t = n->get_x();
-
-					unordered_map<int, bool> var_map=n->get_soln();
-					
-					var_map[-(n->get_id())]=false;
-					var_map[n->get_id()]=true;
-					cost = expr.eval_expression_neg(var_map);
-
-					Node * right_child = new Node;
-
-					if(cur_lvl<=THRESHOLD || ((cost+1 >= lb ) && (int) next_lvl.size() <=NODES_REQ)) {				
-						right_child->init_node(n, next_id, cur_uid++, true);
-						right_child->add_var_to_soln(var_map);
-						right_child->set_pos(x_pos_t+x_incr, y_pos);					
-						n->set_rh_child(right_child);
-						next_lvl.push_back(right_child);
+				for(int i = 0; i < lvl_size; ++i) {
+					for(int b = 0; b < 2; ++b) {
+						cost_t cost=child_cost[2*i+b];
+						if(cost < cutoff && (cur_lvl<=THRESHOLD || ((cost+1 >= lb ) && (int) plan.size() <=NODES_REQ)) && !(use_bound && bfs_bound_cuts(lvl_soln[i], lvl.get_var(), b == 0, decided, lb))) {
+							ChildPlan p={cost, i, b == 0};
+							plan.push_back(p);
+						}
 					}
-
-					var_map=n->get_soln();
-
-					var_map[n->get_id()]=false;
-					var_map[-(n->get_id())]=true;
-					cost = expr.eval_expression_neg(var_map);
-					
-					Node * left_child = new Node;
-
-					if( cur_lvl<=THRESHOLD || ((cost+1 >= lb  ) && (int) next_lvl.size() <=NODES_REQ)) {
-						left_child->init_node(n, next_id, cur_uid++, false);
-						left_child->add_var_to_soln(var_map);
-						left_child->set_pos(x_pos_t-x_incr, y_pos);						
-						n->set_lh_child(left_child);
-						next_lvl.push_back(left_child);
-					}
-				}				
+				}
 			}
+
+			// build the survivors, each thread filling its own slice of next_lvl.
+			next_lvl.init_level(next_id, (int)plan.size());
+			next_soln.resize(plan.size());
+			pool.parallel_for((int)plan.size(), [&](int begin, int end) {
+				for(int k = begin; k < end; ++k) {
+					int p=plan[k].parent;
+					next_soln[k]=lvl_soln[p];
+					next_soln[k].set_var(lvl.get_var(), plan[k].val);
+					next_lvl.set_node(k, p, plan[k].val, plan[k].cost, plan[k].val ? lvl.get_x(p)+x_incr : lvl.get_x(p)-x_incr, y_pos);
+				}
+			});
 		}
 		
 		if(cur_lvl==num_of_vars) {
 			LOG(INFO) << "Exiting Search..";
 			searching=false;
 		} else {
-			tree.push_back(next_lvl);
+			tree_bytes+=next_lvl.get_bytes();
+			tree.push_back(std::move(next_lvl));
+			peak_tree=max(peak_tree, tree_bytes);
+			if(!keep_tree) {
+				// nothing reads this level again: the frontier has its own 
+				// assignments, and the levels' vars are all a path needs.
+				tree_bytes-=tree[cur_lvl].get_bytes();
+				tree[cur_lvl].release();
+			}
+			lvl_soln.swap(next_soln);			// old level's assignments are reused as scratch.
 			if(NODES_REQ>=128 && cur_lvl>THRESHOLD){
 				if(should_red || is_opt){
 					NODES_REQ/=2;
@@ -300,70 +502,382 @@ void MS_Solver::solve() {
 				x_incr/=2;
 			}
 
-			vars_used_map[next_id]=true;
+			lvl_id=next_id;
 		}
 	}
 
 	LOG(INFO) << "Tree Found";
 	auto end = std::chrono::system_clock::now();	
+	unsigned long long allocs_search=get_alloc_count()-allocs_start;
 	
-	int max=0;
+	// node costs are exact, so the best leaf is one scan of the cost array. 
+	// Nodes on a level differ only in decided vars: all are complete or none.
+	cost_t min_cost=LLONG_MAX;
 	int index=0;
-	for(int i=0; i< (int)tree[cur_lvl].size(); ++i) {
-		if(expr.eval_expression(tree[cur_lvl][i]->get_soln()) > max && (int) tree[cur_lvl][i]->get_soln().size() == 2*num_of_vars) {
-			max=expr.eval_expression(tree[cur_lvl][i]->get_soln());
-			index=i;
+	const cost_t * leaf_costs=tree[cur_lvl].get_costs();
+	int num_leaves=tree[cur_lvl].get_size();
+	if(num_leaves > 0 && lvl_soln[0].is_complete()) {
+		for(int i=0; i< num_leaves; ++i) {
+			if(leaf_costs[i] < min_cost) {
+				min_cost=leaf_costs[i];
+				index=i;
+			}
 		}
 	}
 
 	soln_idx=index;
 	soln_lvl=cur_lvl;
+	if(min_cost < LLONG_MAX) {
+		offer_incumbent(lvl_soln[index], min_cost);
+	}
 
 	LOG(INFO) << "---";
-	for(const auto& key : tree[cur_lvl][index]->get_soln()) {
-		if(key.first > 0){
-			if(key.second) {
-				printf("Var [%d] = TRUE\n", key.first);
+	status=(best_cost < hard_weight) ? STATUS_FEASIBLE : STATUS_UNKNOWN;
+	print_soln(best_soln);
+	
+	LOG(STATS) << " ~-> Satisfied Clauses: "<<expr.eval_expression(best_soln)<<"/"<<num_of_clauses;
+	report_cost(best_cost);
+
+	tree_t=std::move(tree);
+
+	LOG(STATS) << " ~-> Visited: "<<nodes_visited<< "/"<<pow(2, num_of_vars);
+	LOG(STATS) << " ~-> Bound Prunes: "<<bound_prunes;
+	LOG(STATS) << " ~-> Peak Tree: "<<peak_tree/1024<<" KB";
+	LOG(STATS) << " ~-> Peak Frontier: "<<peak_frontier/1024<<" KB";
+	LOG(STATS) << " ~-> Allocations: "<<allocs_search<<" ("<<(double)allocs_search/std::max(nodes_visited, 1ULL)<<" per expanded node)";
+	chrono::duration<double> elapsed_seconds = end-start;
+	LOG(STATS) << " ~-> Time Elapsed: " << elapsed_seconds.count() << " seconds.";
+}
+
+
+void MS_Solver::init_order() {
+	int first_var=(order_type == ORDER_START) ? select_start() : 0;
+	var_order.init_order(expr, num_of_vars, order_type, first_var);
+}
+
+// the all-true assignment is the first incumbent.
+void MS_Solver::init_incumbent() {
+	Assignment all_true;
+	all_true.init_assignment(num_of_vars, max_var);
+	for(int i = 1; i<=num_of_vars; ++i) {
+		all_true.set_var(i, true);
+	}
+	ub=hard_weight;
+	offer_incumbent(all_true, expr.eval_expression_neg(all_true));
+	LOG(INFO) << " ~ Initial Upper Bound: "<<ub;
+}
+
+// weighted instances also get the soft cost and the hard clauses broken.
+void MS_Solver::report_cost(cost_t cost) {
+	if(!expr.is_weighted()) {
+		return;
+	}
+	LOG(STATS) << " ~-> Cost: "<<cost % hard_weight;
+	if(expr.get_num_hard() > 0) {
+		LOG(STATS) << " ~-> Hard Clauses Broken: "<<cost / hard_weight<<"/"<<expr.get_num_hard();
+	}
+}
+
+void MS_Solver::report_exact(chrono::duration<double> elapsed_seconds) {
+	soln_idx=0;
+	soln_lvl=0;
+
+	LOG(INFO) << "---";
+	print_soln(best_soln);
+
+	if(stopped) {
+		status=(best_cost < hard_weight) ? STATUS_FEASIBLE : STATUS_UNKNOWN;
+	} else {
+		status=(best_cost < hard_weight) ? STATUS_OPTIMUM : STATUS_UNSAT;
+	}
+	if(status == STATUS_UNSAT) {
+		LOG(STATS) << " ~-> No assignment satisfies the hard clauses.";
+	} else if(status == STATUS_UNKNOWN) {
+		LOG(STATS) << " ~-> No assignment satisfying the hard clauses found before the limit.";
+	} else {
+		LOG(STATS) << " ~-> Satisfied Clauses: "<<expr.eval_expression(best_soln)<<"/"<<num_of_clauses<<(stopped ? " (limit reached)" : " (optimal)");
+		report_cost(best_cost);
+	}
+	LOG(STATS) << " ~-> Visited: "<<nodes_visited;
+	LOG(STATS) << " ~-> Bound Prunes: "<<bound_prunes;
+	LOG(STATS) << " ~-> Nodes/Second: "<<nodes_visited/std::max(elapsed_seconds.count(), 1e-9);
+	LOG(STATS) << " ~-> Time Elapsed: " << elapsed_seconds.count() << " seconds.";
+}
+
+
+/******************************************
+* Depth-first branch and bound. The current
+* path is a trail of (var, cost) entries, so
+* memory is O(vars); a subtree is cut as soon
+* as its cost reaches the best complete 
+* assignment found so far (or breaks a hard
+* clause), so the result is optimal when the
+* search ends.
+******************************************/
+void MS_Solver::solve_dfs() {
+	auto start = std::chrono::system_clock::now();
+	LOG(STATS) << " * Initializing Timer *";
+
+	init_order();
+	init_incumbent();
+
+	Assignment cur;
+	cur.init_assignment(num_of_vars, max_var);
+	dfs_from(cur, 0, expr.eval_expression_neg(cur));
+
+	LOG(INFO) << (stopped ? "Search Stopped" : "Search Exhausted");
+	auto end = std::chrono::system_clock::now();
+	report_exact(end-start);
+}
+
+// exhausts the subtree below cur, which has base_depth vars set.
+void MS_Solver::dfs_from(Assignment & cur, int base_depth, cost_t base_cost) {
+	vector<cost_t> trail_cost(num_of_vars+1, 0);	// false clause weight at each depth.
+	vector<cost_t> other_delta(num_of_vars, 0);		// delta of the branch not yet taken.
+	vector<char> tried(num_of_vars+1, 0);			// branches taken at each depth.
+	vector<char> first_val(num_of_vars, 0);			// polarity taken first at each depth.
+	vector<int> var_at(num_of_vars, 0);				// var branched on at each depth.
+
+	int depth=base_depth;
+	trail_cost[depth]=base_cost;
+
+	unsigned long long next_check=nodes_visited;
+	while(depth >= base_depth) {
+		if(nodes_visited >= next_check) {
+			next_check=nodes_visited+1024;
+			if(budget_spent(0)) {
+				break;
+			}
+		}
+		if(depth == num_of_vars || trail_cost[depth] >= ub || tried[depth] == 2) {
+			if(depth == num_of_vars && trail_cost[depth] < ub) {
+				offer_incumbent(cur, trail_cost[depth]);
+			}
+			tried[depth]=0;
+			--depth;
+			if(depth >= base_depth) {
+				cur.unset_var(var_at[depth]);
+			}
+			continue;
+		}
+
+		if(tried[depth] == 0) {
+			var_at[depth]=var_order.pick_var(depth, cur);
+		}
+		int var=var_at[depth];
+		bool val;
+		cost_t delta;
+		if(tried[depth] == 0 && bound_type != BOUND_NONE && trail_cost[depth]+bound.eval_bound(cur) >= ub) {
+			++bound_prunes;
+			tried[depth]=2;
+			continue;
+		}
+		if(tried[depth] == 0) {
+			cost_t delta_true 	=	expr.eval_delta_neg(cur, var, true);
+			cost_t delta_false 	=	expr.eval_delta_neg(cur, var, false);
+			first_val[depth] 	=	delta_true <= delta_false;
+			val 				=	first_val[depth];
+			delta 				=	val ? delta_true : delta_false;
+			other_delta[depth] 	=	val ? delta_false : delta_true;
+		} else {
+			val 	=	!first_val[depth];
+			delta 	=	other_delta[depth];
+		}
+		++tried[depth];
+		++nodes_visited;
+
+		cur.set_var(var, val);
+		trail_cost[depth+1]=trail_cost[depth]+delta;
+		++depth;
+	}
+}
+
+
+/******************************************
+* Best-first search. Frontier nodes sit in 
+* a binary heap keyed by a lower bound 
+* (false clause weight plus eval_bound),
+* deepest first on ties. A node is a 24 byte
+* record (cost, parent, decision, depth); its
+* assignment is rebuilt from the parent chain
+* when it is expanded. Once the records and 
+* heap pass mem_cap, the remaining frontier
+* is finished off depth-first.
+******************************************/
+struct OpenEntry {
+	cost_t key;
+	int depth;
+	int idx;
+};
+
+struct OpenEntryCmp {
+	bool operator()(const OpenEntry & a, const OpenEntry & b) const {
+		if(a.key != b.key) {
+			return a.key > b.key;
+		}
+		if(a.depth != b.depth) {
+			return a.depth < b.depth;
+		}
+		return a.idx > b.idx;
+	}
+};
+
+void MS_Solver::rebuild_soln(int idx, Assignment & cur) {
+	cur.init_assignment(num_of_vars, max_var);
+	for(; records[idx].parent >= 0; idx=records[idx].parent) {
+		int lit=records[idx].lit;
+		cur.set_var(abs(lit), lit > 0);
+	}
+}
+
+void MS_Solver::solve_best_first() {
+	auto start = std::chrono::system_clock::now();
+	LOG(STATS) << " * Initializing Timer *";
+
+	init_order();
+	init_incumbent();
+
+	priority_queue<OpenEntry, vector<OpenEntry>, OpenEntryCmp> open;
+	Assignment cur;
+	Assignment greedy;
+	cur.init_assignment(num_of_vars, max_var);
+
+	SearchRecord root;
+	root.parent 	=	-1;
+	root.lit 		=	0;
+	root.depth 		=	0;
+	root.cost 		=	expr.eval_expression_neg(cur);
+
+	records.clear();
+	records.push_back(root);
+	OpenEntry root_entry={root.cost + bound.eval_bound(cur), 0, 0};
+	open.push(root_entry);
+
+	bool capped=false;
+	size_t peak_bytes=0;
+	unsigned long long pops=0;
+
+	while(!open.empty()) {
+		OpenEntry top=open.top();
+		if(top.key >= ub) {
+			break;						// nothing left can beat the incumbent.
+		}
+
+		size_t bytes=records.size()*sizeof(SearchRecord) + open.size()*sizeof(OpenEntry);
+		peak_bytes=std::max(peak_bytes, bytes);
+		bool checkpoint=(pops++ % 64) == 0;
+		if(checkpoint && budget_spent(bytes)) {
+			break;
+		}
+		if(bytes >= mem_cap) {
+			capped=true;
+			break;
+		}
+		open.pop();
+
+		SearchRecord rec=records[top.idx];
+		rebuild_soln(top.idx, cur);
+		if(checkpoint) {
+			// anytime: finish this node greedily, since leaves come late in best-first order.
+			greedy=cur;
+			offer_incumbent(greedy, complete_greedy(greedy, rec.cost));
+		}
+
+		int var=var_order.pick_var(rec.depth, cur);
+		for(int b = 0; b < 2; ++b) {
+			bool val=(b == 0);
+			cost_t cost=rec.cost + expr.eval_delta_neg(cur, var, val);
+			if(cost >= ub) {
+				continue;
+			}
+			++nodes_visited;
+
+			cur.set_var(var, val);
+			if(rec.depth+1 == num_of_vars) {
+				offer_incumbent(cur, cost);
 			} else {
-				printf("Var [%d] = FALSE\n", key.first);
+				cost_t node_bound=cost + bound.eval_bound(cur);
+				if(node_bound >= ub) {
+					++bound_prunes;
+				} else {
+					SearchRecord child;
+					child.parent 	=	top.idx;
+					child.lit 		=	val ? var : -var;
+					child.depth 	=	rec.depth+1;
+					child.cost 		=	cost;
+					records.push_back(child);
+					OpenEntry entry={node_bound, child.depth, (int)records.size()-1};
+					open.push(entry);
+				}
 			}
+			cur.unset_var(var);
 		}
 	}
-	
-	LOG(STATS) << " ~-> Satisfied Clauses: "<<expr.eval_expression(tree[cur_lvl][index]->get_soln())<<"/"<<num_of_clauses;
-	int nodes_visited=0;
-	for(int i = 0; i < (int)tree.size(); ++i) {
-		for(int j = 0; j < (int)tree[i].size(); ++j) {
-			if(i<(int)tree.size()-1) {
-				++nodes_visited;
+
+	if(capped) {
+		LOG(WARNING) << " ~ Memory cap reached with "<<open.size()<<" open nodes, finishing depth-first.";
+		while(!open.empty()) {
+			OpenEntry top=open.top();
+			open.pop();
+			if(top.key >= ub || stopped) {
+				break;
 			}
+			rebuild_soln(top.idx, cur);
+			dfs_from(cur, records[top.idx].depth, records[top.idx].cost);
 		}
 	}
 
-	tree_t=tree;
+	records.clear();
+	records.shrink_to_fit();
 
-	LOG(STATS) << " ~-> Visited: "<<nodes_visited<< "/"<<pow(2, num_of_vars);
-	chrono::duration<double> elapsed_seconds = end-start;
-	LOG(STATS) << " ~-> Time Elapsed: " << elapsed_seconds.count() << " seconds.";
+	LOG(INFO) << (stopped ? "Search Stopped" : "Search Exhausted");
+	auto end = std::chrono::system_clock::now();
+	LOG(STATS) << " ~-> Peak Open List: "<<peak_bytes/1024<<" KB";
+	report_exact(end-start);
 }
 
 
-vector< vector<Node *> > MS_Solver::grab_soln_tree() {
+// true if no completion of the decided part of soln (with var=val) can 
+// cost target or less.
+bool MS_Solver::bfs_bound_cuts(const Assignment & soln, int var, bool val, const Assignment & decided, cost_t target) {
+	partial=soln;
+	partial.set_var(var, val);
+	partial.restrict_to(decided);
+	if(expr.eval_expression_neg(partial)+bound.eval_bound(partial) > target) {
+		++bound_prunes;
+		return true;
+	}
+	return false;
+}
+
+const vector<TreeLevel> & MS_Solver::grab_soln_tree() const {
 	return tree_t;
 }
 
 void MS_Solver::cut_tree() {
-	for(int i = 0; i < (int)tree_t.size(); ++i) {
-		for(int j = 0; j < (int)tree_t[i].size(); ++j) {
-			delete tree_t[i][j];
-		}
-	}	
+	tree_t.clear();
 }
 
-int MS_Solver::get_soln_idx() {
+int MS_Solver::get_soln_idx() const {
 	return soln_idx;
 }
 
-int MS_Solver::get_soln_lvl() {
+int MS_Solver::get_soln_lvl() const {
 	return soln_lvl;
+}
+
+cost_t MS_Solver::get_best_cost() const {
+	return best_cost;
+}
+
+cost_t MS_Solver::get_printed_cost() const {
+	return printed_cost;
+}
+
+SolveStatus MS_Solver::get_status() const {
+	return status;
+}
+
+const Assignment & MS_Solver::get_best_soln() const {
+	return best_soln;
 }
\ No newline at end of file
@@ -2,37 +2,134 @@
 #define __MS_SOLVER_H__
 
 #include "expression.h"
-#include "node.h"
+#include "bound.h"
+#include "var_order.h"
+#include "thread_pool.h"
+#include "tree_level.h"
+#include "bit_eval.h"
+
+#define DEFAULT_MEM_CAP 	(256UL << 20)		// bytes of open list before best-first falls back to dfs.
+
+enum SearchMode { MODE_BFS, MODE_DFS, MODE_BEST_FIRST };
+enum SolveStatus { STATUS_UNKNOWN, STATUS_FEASIBLE, STATUS_OPTIMUM, STATUS_UNSAT };
+
+// everything the command line can set, so a batch can hand it to each solver.
+struct SolverOptions {
+	bool is_opt;
+	SearchMode mode;
+	size_t mem_cap;
+	int bound_type;			// -1: up for dfs/best, none for bfs.
+	OrderType order_type;
+	int num_threads;
+	bool quiet;
+	double time_limit;			// seconds of search, 0 for none.
+	unsigned long long node_limit;	// nodes expanded, 0 for none.
+	size_t mem_limit;			// bytes of search structures, 0 for none.
+	bool progress;				// print "o <cost>" on stdout as the incumbent improves.
+	bool keep_tree;				// bfs keeps every level for drawscreen.
+};
+
+struct SearchRecord {
+	cost_t cost;		// weight of false clauses.
+	int parent;			// index of parent record, -1 for the root.
+	int lit;			// decision taken to reach this node (0 for the root).
+	int depth;			// number of decisions on the path.
+};
+
+struct ChildPlan {
+	cost_t cost;		// weight of false clauses.
+	int parent;			// index of parent in its level.
+	bool val;			// value given to the parent's var.
+};
 
 class MS_Solver {
 	private:
 
-		unordered_map<int, bool> vars_used_map;
-		vector< vector<Node *> > tree_t;
+		vector<TreeLevel> tree_t;	// bfs tree, one level per var.
 
 		Expression expr;
+		BitEval bit_eval;			// scores the children of a bfs level.
 
 		int soln_idx;
 		int soln_lvl;
 
 		int num_of_clauses;
 		int num_of_vars;
+		int max_var;		// largest var in any clause; past num_of_vars it stays unassigned.
 
-		int lb;			//lower bound
+		cost_t lb;			//lower bound
 		bool is_opt;
+		SearchMode mode;
+
+		Assignment best_soln;	// best complete assignment of the last search.
+		cost_t ub;				// cost of best_soln (exact modes), at most hard_weight.
+		cost_t hard_weight;		// any cost this high breaks a hard clause.
+		cost_t best_cost;		// cost of best_soln once solve() returns.
+		cost_t printed_cost;	// last "o" line written, LLONG_MAX if none.
+		SolveStatus status;
+		bool quiet;				// no per-variable printout.
+
+		double time_limit;
+		unsigned long long node_limit;
+		size_t mem_limit;
+		bool progress;
+		bool keep_tree;						// else bfs frees each level once its children are built.
+		chrono::steady_clock::time_point search_start;
+		bool stopped;						// a limit ran out; the result is the incumbent.
+		VarOrder var_order;
+		OrderType order_type;
+		vector<SearchRecord> records;
+		size_t mem_cap;
+		unsigned long long nodes_visited;
+
+		LowerBound bound;
+		BoundType bound_type;
+		unsigned long long bound_prunes;	// nodes cut only thanks to the bound.
+		Assignment partial;					// scratch for bfs_bound_cuts.
+
+		ThreadPool pool;					// bfs level expansion.
+		int num_threads;
 
 		int select_start();
+		bool budget_spent(size_t bytes);
+		void offer_incumbent(const Assignment & soln, cost_t cost);
+		cost_t complete_greedy(Assignment & soln, cost_t cost);
+		void init_order();
+		void init_incumbent();
+		void solve_bfs();
+		bool bfs_bound_cuts(const Assignment & soln, int var, bool val, const Assignment & decided, cost_t target);
+		void solve_dfs();
+		void dfs_from(Assignment & cur, int base_depth, cost_t base_cost);
+		void solve_best_first();
+		void rebuild_soln(int idx, Assignment & cur);
+		void report_cost(cost_t cost);						// of best_soln, already known.
+		void report_exact(chrono::duration<double> elapsed_seconds);
+		void print_soln(const Assignment & soln);
 
 	public:
 		MS_Solver(){};
 		
-		void init_solver(Expression expr, int num_of_clauses, int num_of_vars);
+		void init_solver(Expression && expr, int num_of_clauses, int num_of_vars);		// takes over expr's clauses.
 		void solve();
+		void set_options(const SolverOptions & opts);
 		void set_optimal(bool is_opt);
-		vector< vector<Node *> > grab_soln_tree();
+		void set_mode(SearchMode mode);
+		void set_mem_cap(size_t mem_cap);
+		void set_bound(BoundType bound_type);
+		void set_order(OrderType order_type);
+		void set_threads(int num_threads);
+		void set_quiet(bool quiet);
+		void set_limits(double time_limit, unsigned long long node_limit, size_t mem_limit);
+		void set_progress(bool progress);
+		void set_keep_tree(bool keep_tree);
+		const Assignment & get_best_soln() const;
+		cost_t get_best_cost() const;					// weight of false soft clauses.
+		cost_t get_printed_cost() const;				// last progress "o" line, LLONG_MAX if none.
+		SolveStatus get_status() const;
+		const vector<TreeLevel> & grab_soln_tree() const;
 		void cut_tree();
-		int get_soln_idx();
-		int get_soln_lvl();
+		int get_soln_idx() const;
+		int get_soln_lvl() const;
 };
 
 #endif
\ No newline at end of file
@@ -1,14 +1,21 @@
 #include <fstream>
 #include <iostream>
 #include <string.h>
+#include <unistd.h>
+#include <thread>
 #include "graphics.h"
 #include "ms_solver.h"
+#include "compiled.h"
+#include "instance.h"
+#include "batch.h"
 
-char cmd_list[]="Usage ./ms_util -file [filename] -opt [y|n]";
+char cmd_list[]="Usage ./ms_util -file [filename] -opt [y|n] [-mode bfs|dfs|best] [-memcap MB] [-bound none|unit|up] [-order start|occ|moms|jw|dyn] [-threads N] [-time S] [-nodes N] [-memlimit MB] [-headless]\n       ./ms_util -batch [dir|manifest] -opt [y|n] [same options] [-jobs N]\n       ./ms_util -compile [in] [out]";
 
-Expression expr;
-MS_Solver mss;
-vector< vector<Node *> > tree_plot;
+#define EXIT_SATISFIABLE 	10 		// headless exit codes, as MaxSAT evaluations read them.
+#define EXIT_UNSATISFIABLE 	20
+#define EXIT_OPTIMUM 		30
+
+const MS_Solver * shown=NULL;		// solver whose tree drawscreen shows.
 
 // function references for graphics.
 void drawscreen(void);
@@ -16,80 +23,127 @@ void act_on_button_press (float x, float y);
 void act_on_mouse_move (float x, float y);
 void act_on_key_press (char c);
 
-void read_in_expression(char * filename) {
-	FILE *fp;
-	char line[128];
-	bool first_line_read	=	false;
-	short delim_count		=	0;
-	
-	int num_of_clauses=0;
-	int num_of_vars=0;
-	
-	vector< vector<int> > clauses;
-
-	fp=fopen(filename, "r");
-	LOG(INFO) << "Attempting to open file ["<< filename<<"]";
-
-
-	if(fp) {
-		LOG(INFO) << "Reading file.";
-		
-		while(fgets(line,128,fp) != NULL) {
-				char * token = strtok(line, " ");
-				vector<int> current_clause;
-
-				while(token != NULL) {
-					if(!first_line_read && delim_count < 2) {
-						if(delim_count==1) {
-							num_of_clauses=atoi(token);
-							LOG(INFO) << "Number of clauses:     --> ["<<num_of_clauses<<"]";
-							
-							first_line_read=true;
-
-						} else {
-							num_of_vars=atoi(token);
-							LOG(INFO) << "Number of variables:   --> ["<<num_of_vars<<"]";
-						}
-					} else {
-						if(atoi(token)==0) {
-							clauses.push_back(current_clause);
-						} else {
-							current_clause.push_back(atoi(token));
-						}
-					}
-					delim_count++;
-					token = strtok(NULL, " ");
-				}
-		}
+// MaxSAT evaluation output: o <cost>, s <status>, v <literals>.
+void write_result(FILE * out, const MS_Solver & mss) {
+	SolveStatus status=mss.get_status();
+	const Assignment & soln=mss.get_best_soln();
 
-		fclose(fp);
-	} else {
-		LOG(ERROR) << "File does not exist.";
-		exit(-1);
+	// progress lines may already have given the final cost.
+	if((status == STATUS_OPTIMUM || status == STATUS_FEASIBLE) && mss.get_best_cost() != mss.get_printed_cost()) {
+		fprintf(out, "o %lld\n", mss.get_best_cost());
+	}
+	switch(status) {
+		case STATUS_OPTIMUM:
+			fprintf(out, "s OPTIMUM FOUND\n");
+			break;
+		case STATUS_FEASIBLE:
+			fprintf(out, "s SATISFIABLE\n");
+			break;
+		case STATUS_UNSAT:
+			fprintf(out, "s UNSATISFIABLE\n");
+			return;
+		default:
+			fprintf(out, "s UNKNOWN\n");
+			return;
 	}
 
-	LOG(INFO) << "Forming into expression.";
+	fprintf(out, "v");
+	for(int var = 1; var <= soln.get_num_vars(); ++var) {
+		bool val=soln.is_assigned(var) && soln.get_val(var);
+		fprintf(out, " %d", val ? var : -var);
+	}
+	fprintf(out, "\n");
+	fflush(out);
+}
+
+// UNKNOWN exits 0: the run finished, it just has no answer to report.
+int exit_status(SolveStatus status) {
+	switch(status) {
+		case STATUS_OPTIMUM:
+			return EXIT_OPTIMUM;
+		case STATUS_FEASIBLE:
+			return EXIT_SATISFIABLE;
+		case STATUS_UNSAT:
+			return EXIT_UNSATISFIABLE;
+		default:
+			return OKAY;
+	}
+}
+
+void read_in_expression(const char * filename, Expression & expr, MS_Solver & mss) {
+	InstanceInfo info;
+	string error;
+	if(!load_instance(filename, expr, info, error)) {
+		LOG(ERROR) << error;
+		exit(-1);
+	}
 
-	expr.init_expression(clauses);
-	
 	LOG(INFO) << "Initializing Solver.\n";
 
-	mss.init_solver(expr, num_of_clauses, num_of_vars);
+	mss.init_solver(std::move(expr), info.num_of_clauses, info.num_of_vars);
 
 }
 
+int compile_instance(const char * in, const char * out) {
+	Expression expr;
+	InstanceInfo info;
+	string error;
+	if(!load_instance(in, expr, info, error)) {
+		LOG(ERROR) << error;
+		return FAIL;
+	}
+
+	CompiledInstance compiled;
+	if(!compiled.write_file(out, expr, info.num_of_vars, info.num_of_clauses, info.weighted, info.top)) {
+		LOG(ERROR) << "Cannot write ["<< out<<"]";
+		return FAIL;
+	}
+	LOG(INFO) << "Compiled ["<< in<<"] into ["<< out<<"]";
+	return OKAY;
+}
+
+int run_batch(const char * path, const SolverOptions & opts, int num_jobs) {
+	BatchRunner batch;
+	if(!batch.init_batch(path, opts, num_jobs)) {
+		LOG(ERROR) << "Cannot list ["<< path<<"]";
+		return FAIL;
+	}
+	pLog::ReportingLevel()=WARNING;		// per-instance stats would drown the result lines.
+	return (batch.run(stdout) > 0) ? FAIL : OKAY;		// some file could not be loaded.
+}
+
 
 int main(int argc, char * argv[]) {
 
-	char file[128];
-	bool opt_on=false;
+	string file;
+	SolverOptions opts;
+	opts.is_opt 		=	false;
+	opts.mode 			=	MODE_BFS;
+	opts.mem_cap 		=	DEFAULT_MEM_CAP;
+	opts.bound_type 	=	-1;					// default depends on mode.
+	opts.order_type 	=	ORDER_START;
+	opts.num_threads 	=	1;
+	opts.time_limit 	=	0;
+	opts.node_limit 	=	0;
+	opts.mem_limit 		=	0;
+#ifdef NO_GRAPHICS
+	opts.quiet 			=	true;				// headless.
+#else
+	opts.quiet 			=	false;
+#endif
+	int num_jobs=max(1, (int)thread::hardware_concurrency());
+
+	if(argc == 4 && strcmp(argv[1], "-compile") == 0) {
+		return compile_instance(resolve_path(argv[2]).c_str(), argv[3]);
+	}
 
 	if (argc < 5) {
 		printf("%s\n", cmd_list);
 		return FAIL;
 	}
 
-	if(strcmp(argv[1], "-file") != 0) {
+	bool batch=(strcmp(argv[1], "-batch") == 0);
+	if(strcmp(argv[1], "-file") != 0 && !batch) {
 		printf("%s\n", cmd_list);
 		return FAIL;		
 	}
@@ -101,21 +155,95 @@ int main(int argc, char * argv[]) {
 
 	if(strcmp(argv[4], "y") == 0 || strcmp(argv[4], "Y") == 0 || strcmp(argv[4], "n") == 0 || strcmp(argv[4], "N") == 0) {
 		if(strcmp(argv[4], "y") == 0 || strcmp(argv[4], "Y") == 0){
-			opt_on=true;
+			opts.is_opt=true;
 		}
 	} else {
 		printf("%s\n", cmd_list);
 		return FAIL;
 	}
 
-	strcpy(file, "../inputs/");
-	strcat(file, argv[2]);
+	for(int i = 5; i < argc; i+=2) {
+		if(strcmp(argv[i], "-mode") == 0 && i+1 < argc) {
+			if(strcmp(argv[i+1], "bfs") == 0) {
+				opts.mode=MODE_BFS;
+			} else if(strcmp(argv[i+1], "dfs") == 0) {
+				opts.mode=MODE_DFS;
+			} else if(strcmp(argv[i+1], "best") == 0) {
+				opts.mode=MODE_BEST_FIRST;
+			} else {
+				printf("%s\n", cmd_list);
+				return FAIL;
+			}
+		} else if(strcmp(argv[i], "-bound") == 0 && i+1 < argc) {
+			if(strcmp(argv[i+1], "none") == 0) {
+				opts.bound_type=BOUND_NONE;
+			} else if(strcmp(argv[i+1], "unit") == 0) {
+				opts.bound_type=BOUND_UNIT;
+			} else if(strcmp(argv[i+1], "up") == 0) {
+				opts.bound_type=BOUND_UP;
+			} else {
+				printf("%s\n", cmd_list);
+				return FAIL;
+			}
+		} else if(strcmp(argv[i], "-order") == 0 && i+1 < argc) {
+			if(strcmp(argv[i+1], "start") == 0) {
+				opts.order_type=ORDER_START;
+			} else if(strcmp(argv[i+1], "occ") == 0) {
+				opts.order_type=ORDER_OCCURRENCE;
+			} else if(strcmp(argv[i+1], "moms") == 0) {
+				opts.order_type=ORDER_MOMS;
+			} else if(strcmp(argv[i+1], "jw") == 0) {
+				opts.order_type=ORDER_JW;
+			} else if(strcmp(argv[i+1], "dyn") == 0) {
+				opts.order_type=ORDER_DYNAMIC;
+			} else {
+				printf("%s\n", cmd_list);
+				return FAIL;
+			}
+		} else if(strcmp(argv[i], "-threads") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			opts.num_threads=atoi(argv[i+1]);
+		} else if(strcmp(argv[i], "-memcap") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			opts.mem_cap=(size_t)atoi(argv[i+1]) << 20;
+		} else if(strcmp(argv[i], "-time") == 0 && i+1 < argc && atof(argv[i+1]) > 0) {
+			opts.time_limit=atof(argv[i+1]);
+		} else if(strcmp(argv[i], "-nodes") == 0 && i+1 < argc && atoll(argv[i+1]) > 0) {
+			opts.node_limit=(unsigned long long)atoll(argv[i+1]);
+		} else if(strcmp(argv[i], "-memlimit") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			opts.mem_limit=(size_t)atoi(argv[i+1]) << 20;
+		} else if(strcmp(argv[i], "-jobs") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			num_jobs=atoi(argv[i+1]);
+		} else if(strcmp(argv[i], "-headless") == 0) {
+			opts.quiet=true;
+			--i;								// takes no value.
+		} else {
+			printf("%s\n", cmd_list);
+			return FAIL;
+		}
+	}
+
+	opts.progress=opts.quiet && !batch;			// "o" lines only when stdout is ours alone.
+	opts.keep_tree=!opts.quiet;					// only drawscreen needs the whole tree.
+	if(batch) {
+		return run_batch(argv[2], opts, num_jobs);
+	}
 
-	read_in_expression(file);
-	mss.set_optimal(opt_on);
+	Expression expr;
+	MS_Solver mss;
+	file=resolve_path(argv[2]);
+	read_in_expression(file.c_str(), expr, mss);
+	mss.set_options(opts);
 	mss.solve();
 
-	tree_plot = mss.grab_soln_tree();
+	if(opts.quiet) {
+		write_result(stdout, mss);
+		mss.cut_tree();
+		return exit_status(mss.get_status());
+	}
+
+	if(opts.mode != MODE_BFS) {
+		LOG(INFO) << "No search tree to draw for this mode.";
+		return OKAY;
+	}
 
 	init_graphics("MS_Solver", WHITE);
 
@@ -127,17 +255,19 @@ int main(int argc, char * argv[]) {
 	clearscreen();
 
 	update_message("--- Solution Tree ---");
+	shown=&mss;
 	drawscreen();
   	event_loop(act_on_button_press, NULL, NULL, drawscreen); 
 
 	mss.cut_tree();
 
-	return SUCCESS;
+	return OKAY;
 }
 
 void drawscreen(void) {
 
 	char buf[128];
+	const vector<TreeLevel> & tree_plot=shown->grab_soln_tree();
 
 	set_draw_mode (DRAW_NORMAL);
 	clearscreen();
@@ -146,51 +276,52 @@ void drawscreen(void) {
 
 	setcolor(DARKGREY);
 	for(int i=1; i< (int)tree_plot.size(); ++i) {
-		for(int j=0; j< (int)tree_plot[i].size(); ++j) {
-			for(Node *n : tree_plot[i-1]){
-				if(n->get_uid()==tree_plot[i][j]->get_parent()->get_uid()) {
-					drawline(tree_plot[i][j]->get_x(), tree_plot[i][j]->get_y(), n->get_x(), n->get_y());
-				}
-			}
+		const TreeLevel & lvl=tree_plot[i];
+		const TreeLevel & up=tree_plot[i-1];
+		for(int j=0; j< lvl.get_size(); ++j) {
+			int p=lvl.get_parent(j);
+			drawline(lvl.get_x(j), lvl.get_y(j), up.get_x(p), up.get_y(p));
 		}
 	}
 
 	for(int i=0; i< (int)tree_plot.size(); ++i) {
-		bool is_set=false;
-		for(int j=0; j< (int)tree_plot[i].size(); ++j) {
-			if(tree_plot[i][j]->get_id() != 0) {
-				if(!is_set) {
-					setcolor(BLACK);
-					sprintf(buf, "[%d]", tree_plot[i][j]->get_id());
-					drawtext(tree_plot[i][j]->get_x()+100, tree_plot[i][j]->get_y(), buf, 100);
-					is_set=true;
-				}
+		const TreeLevel & lvl=tree_plot[i];
+		if(lvl.get_var() != 0 && lvl.get_size() > 0) {
+			setcolor(BLACK);
+			sprintf(buf, "[%d]", lvl.get_var());
+			drawtext(lvl.get_x(0)+100, lvl.get_y(0), buf, 100);
+		}
+		for(int j=0; j< lvl.get_size(); ++j) {
+			if(lvl.get_var() != 0) {
 				setcolor(BLUE);
-				drawarc(tree_plot[i][j]->get_x(), tree_plot[i][j]->get_y(), 6, 0, 360);	
+				drawarc(lvl.get_x(j), lvl.get_y(j), 6, 0, 360);	
 				setcolor(MAGENTA);
-				fillarc(tree_plot[i][j]->get_x(), tree_plot[i][j]->get_y(), 6.3, 0, 360);
+				fillarc(lvl.get_x(j), lvl.get_y(j), 6.3, 0, 360);
 			} else {
 				setcolor(CYAN);
-				fillrect(tree_plot[i][j]->get_x()-4, tree_plot[i][j]->get_y()-4, tree_plot[i][j]->get_x()+4, tree_plot[i][j]->get_y()+4);
+				fillrect(lvl.get_x(j)-4, lvl.get_y(j)-4, lvl.get_x(j)+4, lvl.get_y(j)+4);
 			}
 
 		}
 	}
 
-	Node * CUR=tree_plot[mss.get_soln_lvl()][mss.get_soln_idx()];
-	while(CUR != NULL) {
+	// the best leaf, then parent indices up to the root.
+	int cur=shown->get_soln_idx();
+	for(int i=shown->get_soln_lvl(); i>=0 && cur >= 0 && cur < tree_plot[i].get_size(); --i) {
+			const TreeLevel & lvl=tree_plot[i];
+			int p=lvl.get_parent(cur);
 			setcolor(RED);
-			if(CUR->get_parent() != NULL) {
-				drawline(CUR->get_x(), CUR->get_y(), CUR->get_parent()->get_x(), CUR->get_parent()->get_y());
+			if(p >= 0) {
+				drawline(lvl.get_x(cur), lvl.get_y(cur), tree_plot[i-1].get_x(p), tree_plot[i-1].get_y(p));
 			}
-			if(CUR->get_id() != 0){
+			if(lvl.get_var() != 0){
 				setcolor(GREEN);
-				fillarc(CUR->get_x(), CUR->get_y(), 7, 0, 360);
+				fillarc(lvl.get_x(cur), lvl.get_y(cur), 7, 0, 360);
 			} else {
 				setcolor(CYAN);
-				fillrect(CUR->get_x()-4, CUR->get_y()-4, CUR->get_x()+4, CUR->get_y()+4);
+				fillrect(lvl.get_x(cur)-4, lvl.get_y(cur)-4, lvl.get_x(cur)+4, lvl.get_y(cur)+4);
 			}
-			CUR=CUR->get_parent();	
+			cur=p;
 	}
 
 
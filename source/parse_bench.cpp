@@ -0,0 +1,111 @@
+/******************************************
+* Load-throughput benchmark for DimacsParser
+* and compiled (-compile) instances.
+* Times parse_file over each file given (best
+* of a few runs) and reports MB/s and 
+* clauses/s. "-gen MB path" first writes a 
+* random 3-CNF of about MB megabytes to path,
+* for multi-GB runs the inputs/ set can't give.
+******************************************/
+#include <string.h>
+#include <sys/stat.h>
+#include "dimacs.h"
+#include "compiled.h"
+
+#define BENCH_RUNS 	3
+
+char cmd_list[]="Usage ./parse_bench [-runs N] [-gen MB path] [file ...]";
+
+void gen_instance(const char * path, long long mb) {
+	FILE * fp=fopen(path, "w");
+	if(fp == NULL) {
+		LOG(ERROR) << "Cannot write ["<< path<<"]";
+		exit(-1);
+	}
+
+	long long bytes 	=	mb << 20;
+	int num_of_vars 	=	1000000;
+	long long clauses 	=	bytes / 24;			// ~24 bytes per 3-literal clause.
+	fprintf(fp, "p cnf %d %lld\n", num_of_vars, clauses);
+
+	unsigned long long x=88172645463325252ULL;
+	for(long long c=0; c<clauses; ++c) {
+		for(int k=0; k<3; ++k) {
+			x^=x<<13;	x^=x>>7;	x^=x<<17;
+			int var=(int)(x % num_of_vars) + 1;
+			fprintf(fp, "%d ", (x & (1ULL << 40)) ? var : -var);
+		}
+		fputs("0\n", fp);
+	}
+	fclose(fp);
+	LOG(INFO) << "Wrote "<<clauses<<" clauses to ["<< path<<"]";
+}
+
+// false, with no timings, if the file does not load.
+bool bench_file(const char * path, int runs) {
+	struct stat st;
+	if(stat(path, &st) != 0) {
+		LOG(ERROR) << "Cannot open ["<< path<<"]";
+		return false;
+	}
+
+	double best=0;
+	int num_of_clauses=0;
+	for(int r=0; r<runs; ++r) {
+		Expression expr;
+		bool loaded;
+		auto start=chrono::steady_clock::now();
+		if(CompiledInstance::is_compiled(path)) {
+			CompiledInstance compiled;
+			loaded=compiled.load_file(path, expr);
+		} else {
+			DimacsParser parser;
+			loaded=parser.parse_file(path, expr) && !parser.is_bad() && parser.has_header();
+		}
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+		if(!loaded) {
+			LOG(ERROR) << "Cannot load ["<< path<<"]";
+			return false;
+		}
+		if(r == 0 || elapsed.count() < best) {
+			best=elapsed.count();
+		}
+		num_of_clauses=expr.get_num_clauses();
+	}
+
+	double mb=(double)st.st_size / (1 << 20);
+	LOG(STATS) << path;
+	LOG(STATS) << " ~-> Size: "<<mb<<" MB, Clauses: "<<num_of_clauses;
+	LOG(STATS) << " ~-> Time: "<<best<<"s, "<<mb/best<<" MB/s, "<<num_of_clauses/best<<" clauses/s";
+	return true;
+}
+
+int main(int argc, char ** argv) {
+	int runs=BENCH_RUNS;
+	vector<const char *> files;
+
+	for(int i=1; i<argc; ++i) {
+		if(strcmp(argv[i], "-runs") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			runs=atoi(argv[++i]);
+		} else if(strcmp(argv[i], "-gen") == 0 && i+2 < argc && atoll(argv[i+1]) > 0) {
+			gen_instance(argv[i+2], atoll(argv[i+1]));
+			files.push_back(argv[i+2]);
+			i+=2;
+		} else if(argv[i][0] == '-') {
+			printf("%s\n", cmd_list);
+			return FAIL;
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+	if(files.empty()) {
+		printf("%s\n", cmd_list);
+		return FAIL;
+	}
+
+	bool all_loaded=true;
+	for(const char * f : files) {
+		all_loaded=bench_file(f, runs) && all_loaded;
+	}
+	return all_loaded ? OKAY : FAIL;
+}
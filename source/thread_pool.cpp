@@ -0,0 +1,95 @@
+#include "thread_pool.h"
+
+#define MIN_ITEMS_PER_THREAD 	32 		// below this, a slice is not worth a handoff.
+
+
+ThreadPool::ThreadPool() {
+	job 		=	NULL;
+	num_items 	=	0;
+	generation 	=	0;
+	pending 	=	0;
+	stopping 	=	false;
+}
+
+ThreadPool::~ThreadPool() {
+	stop_workers();
+}
+
+void ThreadPool::init_pool(int num_threads) {
+	if(num_threads < 1) {
+		num_threads=1;
+	}
+	if(num_threads == get_num_threads()) {
+		return;
+	}
+	stop_workers();
+	stopping=false;
+	for(int w = 1; w < num_threads; ++w) {
+		workers.push_back(thread(&ThreadPool::worker_loop, this, w, generation));
+	}
+}
+
+int ThreadPool::get_num_threads() const {
+	return (int)workers.size()+1;
+}
+
+void ThreadPool::stop_workers() {
+	{
+		unique_lock<mutex> l(lock);
+		stopping=true;
+	}
+	work_ready.notify_all();
+	for(thread & t : workers) {
+		t.join();
+	}
+	workers.clear();
+}
+
+// seen is the generation at spawn time, so no job can slip past a new worker.
+void ThreadPool::worker_loop(int w, unsigned seen) {
+	while(true) {
+		unique_lock<mutex> l(lock);
+		work_ready.wait(l, [&]{ return stopping || generation != seen; });
+		if(stopping) {
+			return;
+		}
+		seen=generation;
+		const function<void(int, int)> * body=job;
+		int n=num_items;
+		l.unlock();
+
+		int num_threads=get_num_threads();
+		int begin 	=	(int)((long long)n*w/num_threads);
+		int end 	=	(int)((long long)n*(w+1)/num_threads);
+		if(begin < end) {
+			(*body)(begin, end);
+		}
+
+		l.lock();
+		if(--pending == 0) {
+			work_done.notify_one();
+		}
+	}
+}
+
+void ThreadPool::parallel_for(int num_items, const function<void(int, int)> & body) {
+	int num_threads=get_num_threads();
+	if(num_threads == 1 || num_items < MIN_ITEMS_PER_THREAD*num_threads) {
+		body(0, num_items);
+		return;
+	}
+
+	{
+		unique_lock<mutex> l(lock);
+		this->job 		=	&body;
+		this->num_items =	num_items;
+		this->pending 	=	(int)workers.size();
+		++generation;
+	}
+	work_ready.notify_all();
+
+	body(0, (int)((long long)num_items/num_threads));
+
+	unique_lock<mutex> l(lock);
+	work_done.wait(l, [&]{ return pending == 0; });
+}
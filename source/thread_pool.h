@@ -0,0 +1,46 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "bbdefs.h"
+
+
+/******************************************
+* Fixed set of workers for data-parallel 
+* loops. parallel_for splits [0,n) into one
+* contiguous slice per thread (the caller 
+* runs slice 0) and returns once all slices
+* are done, so output written per index is 
+* the same for any thread count.
+******************************************/
+class ThreadPool {
+
+	private:
+		vector<thread> workers;
+		mutex lock;
+		condition_variable work_ready;
+		condition_variable work_done;
+
+		const function<void(int, int)> * job;		// slice body: [begin, end).
+		int num_items;
+		unsigned generation;						// bumped once per parallel_for.
+		int pending;								// workers still on this job.
+		bool stopping;
+
+		void worker_loop(int w, unsigned seen);
+		void stop_workers();
+
+	public:
+		ThreadPool();
+		~ThreadPool();
+
+		void init_pool(int num_threads);
+		int get_num_threads() const;
+		void parallel_for(int num_items, const function<void(int, int)> & body);
+};
+
+
+#endif
@@ -0,0 +1,44 @@
+#include "tree_level.h"
+
+
+void TreeLevel::init_level(int var, int size) {
+	this->var=var;
+	parent.assign(size, -1);
+	val.assign(size, 0);
+	cost.assign(size, 0);
+	x.assign(size, 0);
+	y.assign(size, 0);
+}
+
+void TreeLevel::set_node(int i, int parent, bool val, cost_t cost, float x, float y) {
+	this->parent[i] =	parent;
+	this->val[i] 	=	val ? 1 : 0;
+	this->cost[i] 	=	cost;
+	this->x[i] 		=	x;
+	this->y[i] 		=	y;
+}
+
+void TreeLevel::release() {
+	vector<int>().swap(parent);
+	vector<char>().swap(val);
+	vector<cost_t>().swap(cost);
+	vector<float>().swap(x);
+	vector<float>().swap(y);
+}
+
+int TreeLevel::get_var() const {
+	return var;
+}
+
+int TreeLevel::get_size() const {
+	return (int)parent.size();
+}
+
+const cost_t * TreeLevel::get_costs() const {
+	return cost.data();
+}
+
+size_t TreeLevel::get_bytes() const {
+	return parent.capacity()*sizeof(int) + val.capacity() + cost.capacity()*sizeof(cost_t)
+			+ x.capacity()*sizeof(float) + y.capacity()*sizeof(float);
+}
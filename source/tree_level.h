@@ -0,0 +1,71 @@
+#ifndef __TREE_LEVEL_H__
+#define __TREE_LEVEL_H__
+
+#include "bbdefs.h"
+
+
+/******************************************
+* One level of the bfs tree, stored as
+* parallel arrays: entry i of each array
+* belongs to node i. A node names its parent
+* by index into the level above and holds
+* the value the parent's var took, so a path
+* is followed by index. A level is sized
+* once its survivors are known; scans touch
+* only the arrays they need, and a level
+* can be written out as a few flat arrays.
+* A released level keeps only its var, which
+* with a leaf's assignment still spells out
+* the leaf's path.
+******************************************/
+class TreeLevel {
+
+	private:
+		int var;									// var every node here branches on (0: none).
+		vector<int> parent;							// index in the level above, -1 for the root.
+		vector<char> val;							// value the parent's var took.
+		vector<cost_t> cost;						// weight of false clauses on the path.
+		vector<float> x;							// layout for drawscreen.
+		vector<float> y;
+
+	public:
+		TreeLevel(){ var=0; };
+
+		void init_level(int var, int size);			// size nodes, filled in by set_node.
+		void set_node(int i, int parent, bool val, cost_t cost, float x, float y);
+		void release();								// frees the arrays, keeps var.
+
+		int get_var() const;
+		int get_size() const;
+		int get_parent(int i) const;
+		bool get_val(int i) const;
+		cost_t get_cost(int i) const;
+		float get_x(int i) const;
+		float get_y(int i) const;
+		const cost_t * get_costs() const;			// get_size() costs, in node order.
+		size_t get_bytes() const;					// heap held by the arrays.
+};
+
+
+inline int TreeLevel::get_parent(int i) const {
+	return parent[i];
+}
+
+inline bool TreeLevel::get_val(int i) const {
+	return val[i] != 0;
+}
+
+inline cost_t TreeLevel::get_cost(int i) const {
+	return cost[i];
+}
+
+inline float TreeLevel::get_x(int i) const {
+	return x[i];
+}
+
+inline float TreeLevel::get_y(int i) const {
+	return y[i];
+}
+
+
+#endif
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include "var_order.h"
+
+
+void VarOrder::init_order(const Expression & expr, int num_of_vars, OrderType type, int first_var) {
+	this->expr 			=	&expr;
+	this->type 			=	type;
+	this->num_of_vars 	=	num_of_vars;
+
+	order.clear();
+	score.assign(num_of_vars+1, 0);
+
+	if(type == ORDER_START) {
+		if(first_var >= 1 && first_var <= num_of_vars) {
+			order.push_back(first_var);
+		}
+		for(int i = 1; i<=num_of_vars; ++i) {
+			if(i != first_var) {
+				order.push_back(i);
+			}
+		}
+		return;
+	}
+
+	int max_var=min(num_of_vars, expr.get_num_vars());
+	int min_len=0;
+	for(int c = 0; c < expr.get_num_clauses(); ++c) {
+		if(min_len == 0 || expr.get_clause_len(c) < min_len) {
+			min_len=expr.get_clause_len(c);
+		}
+	}
+
+	for(int var = 1; var <= max_var; ++var) {
+		int pos_count, neg_count;
+		const int * pos=expr.get_pos_occ(var, pos_count);
+		const int * neg=expr.get_neg_occ(var, neg_count);
+
+		if(type == ORDER_OCCURRENCE || type == ORDER_DYNAMIC) {
+			score[var]=pos_count+neg_count;
+		} else if(type == ORDER_MOMS) {
+			double f_pos=0, f_neg=0;
+			for(int k = 0; k < pos_count; ++k) {
+				f_pos+=(expr.get_clause_len(pos[k]) == min_len);
+			}
+			for(int k = 0; k < neg_count; ++k) {
+				f_neg+=(expr.get_clause_len(neg[k]) == min_len);
+			}
+			score[var]=(f_pos+f_neg)*1024 + f_pos*f_neg;
+		} else {
+			for(int k = 0; k < pos_count; ++k) {
+				score[var]+=ldexp(1.0, -expr.get_clause_len(pos[k]));
+			}
+			for(int k = 0; k < neg_count; ++k) {
+				score[var]+=ldexp(1.0, -expr.get_clause_len(neg[k]));
+			}
+		}
+	}
+	sort_by_score();
+	if(type == ORDER_DYNAMIC) {
+		init_dynamic();
+	}
+}
+
+void VarOrder::sort_by_score() {
+	order.clear();
+	for(int i = 1; i<=num_of_vars; ++i) {
+		order.push_back(i);
+	}
+	const vector<double> & s=score;
+	stable_sort(order.begin(), order.end(), [&s](int a, int b) { return s[a] > s[b]; });
+}
+
+// scores every clause against the empty assignment, once per search.
+void VarOrder::init_dynamic() {
+	seen.init_assignment(num_of_vars, max(num_of_vars, expr->get_num_vars()));
+	rank.assign(num_of_vars+1, 0);
+	for(int i = 0; i < num_of_vars; ++i) {
+		rank[order[i]]=i;
+	}
+	fill(score.begin(), score.end(), 0);
+	heap.clear();
+	heap_pos.assign(num_of_vars+1, -1);
+	touched.clear();
+	pending.assign(num_of_vars+1, 0);
+	is_touched.assign(num_of_vars+1, 0);
+	for(int c = 0; c < expr->get_num_clauses(); ++c) {
+		score_clause(c, 1);
+	}
+	apply_pending();
+	for(int var : order) {
+		heap_push(var);
+	}
+}
+
+void VarOrder::score_clause(int c, double sign) {
+	const int * clause=expr->get_clause(c);
+	int len=expr->get_clause_len(c);
+	int num_free=0;
+	for(int i = 0; i < len; ++i) {
+		if(seen.is_lit_true(clause[i])) {
+			return;
+		} else if(!seen.is_lit_false(clause[i])) {
+			++num_free;
+		}
+	}
+	if(num_free == 0) {
+		return;
+	}
+	double w=sign*ldexp(1.0, -num_free);
+	for(int i = 0; i < len; ++i) {
+		int var=abs(clause[i]);
+		if(var <= num_of_vars && !seen.is_assigned(var)) {
+			pending[var]+=w;
+			if(!is_touched[var]) {
+				is_touched[var]=1;
+				touched.push_back(var);
+			}
+		}
+	}
+}
+
+// a clause holding both +var and -var sits in both occurrence lists; it is re-priced once.
+void VarOrder::update_var(int var, const Assignment & vals) {
+	changed.clear();
+	if(var <= expr->get_num_vars()) {
+		int count;
+		const int * occ=expr->get_pos_occ(var, count);
+		changed.insert(changed.end(), occ, occ+count);
+		occ=expr->get_neg_occ(var, count);
+		for(int k = 0; k < count; ++k) {
+			const int * clause=expr->get_clause(occ[k]);
+			const int * end=clause+expr->get_clause_len(occ[k]);
+			if(find(clause, end, var) == end) {
+				changed.push_back(occ[k]);
+			}
+		}
+	}
+
+	for(int c : changed) {
+		score_clause(c, -1);
+	}
+	if(vals.is_assigned(var)) {
+		seen.set_var(var, vals.get_val(var));
+	} else {
+		seen.unset_var(var);
+	}
+	for(int c : changed) {
+		score_clause(c, 1);
+	}
+	apply_pending();
+	if(seen.is_assigned(var)) {
+		heap_remove(var);
+	} else {
+		heap_push(var);
+	}
+}
+
+// scores change one var at a time, so each heap fix starts from a valid heap.
+void VarOrder::apply_pending() {
+	for(int var : touched) {
+		score[var]+=pending[var];
+		pending[var] 	=	0;
+		is_touched[var] =	0;
+		heap_fix(var);
+	}
+	touched.clear();
+}
+
+int VarOrder::pick_var(int depth, const Assignment & vals) {
+	if(type != ORDER_DYNAMIC) {
+		return get_var(depth);
+	}
+	if(depth >= num_of_vars) {
+		return 0;
+	}
+
+	for(int var = seen.next_diff(vals, 1); var != 0; var = seen.next_diff(vals, var+1)) {
+		update_var(var, vals);
+	}
+	return heap.empty() ? 0 : heap[0];
+}
+
+// best free var; static occurrence order breaks ties, then lower index.
+bool VarOrder::heap_better(int a, int b) const {
+	return score[a] > score[b] || (score[a] == score[b] && rank[a] < rank[b]);
+}
+
+void VarOrder::heap_move(int i, int var) {
+	heap[i] 		=	var;
+	heap_pos[var] 	=	i;
+}
+
+void VarOrder::heap_push(int var) {
+	if(var > num_of_vars || heap_pos[var] >= 0) {
+		return;
+	}
+	heap.push_back(var);
+	heap_pos[var]=(int)heap.size()-1;
+	heap_fix(var);
+}
+
+void VarOrder::heap_remove(int var) {
+	if(var > num_of_vars || heap_pos[var] < 0) {
+		return;
+	}
+	int i=heap_pos[var];
+	int last=heap.back();
+	heap.pop_back();
+	heap_pos[var]=-1;
+	if(last != var) {
+		heap_move(i, last);
+		heap_fix(last);
+	}
+}
+
+void VarOrder::heap_fix(int var) {
+	if(heap_pos[var] < 0) {
+		return;
+	}
+	int i=heap_pos[var];
+	int size=(int)heap.size();
+	while(i > 0 && heap_better(var, heap[(i-1)/2])) {
+		heap_move(i, heap[(i-1)/2]);
+		i=(i-1)/2;
+	}
+	while(2*i+1 < size) {
+		int child=2*i+1;
+		if(child+1 < size && heap_better(heap[child+1], heap[child])) {
+			++child;
+		}
+		if(!heap_better(heap[child], var)) {
+			break;
+		}
+		heap_move(i, heap[child]);
+		i=child;
+	}
+	heap_move(i, var);
+}
+
+bool VarOrder::is_dynamic() const {
+	return type == ORDER_DYNAMIC;
+}
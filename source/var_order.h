@@ -0,0 +1,78 @@
+#ifndef __VAR_ORDER_H__
+#define __VAR_ORDER_H__
+
+#include "bbdefs.h"
+#include "expression.h"
+
+enum OrderType { ORDER_START, ORDER_OCCURRENCE, ORDER_MOMS, ORDER_JW, ORDER_DYNAMIC };
+
+
+/******************************************
+* Branching order. Static orders are sorted
+* once (ties to the lower var) and read back
+* in O(1) per depth:
+*
+* ORDER_START:      select_start() var, then 
+*                   index order.
+* ORDER_OCCURRENCE: most literal occurrences.
+* ORDER_MOMS:       most occurrences in the 
+*                   shortest clauses.
+* ORDER_JW:         Jeroslow-Wang, sum of 
+*                   2^-len over its clauses.
+*
+* ORDER_DYNAMIC scores the free vars against
+* the assignment at hand instead: JW over 
+* the clauses it has not yet satisfied, 
+* counting only their free literals. The 
+* scores describe the last assignment seen;
+* a pick re-prices only the clauses of the 
+* vars that changed since (their occurrence
+* lists) and reads the best free var off a
+* heap, ties to the static occurrence order.
+******************************************/
+class VarOrder {
+
+	private:
+		const Expression * expr;
+		OrderType type;
+		int num_of_vars;
+
+		vector<int> order;									// var per depth.
+		vector<double> score;								// static score, then dynamic JW.
+
+		Assignment seen;									// assignment the dynamic scores describe.
+		vector<int> rank;									// position of each var in order.
+		vector<int> heap;									// free vars, best first.
+		vector<int> heap_pos;								// index of each var in heap, -1 if absent.
+		vector<int> changed;								// clauses holding the var being updated.
+		vector<int> touched;								// vars whose score those clauses moved.
+		vector<double> pending;								// net move of each touched var, not yet in score.
+		vector<char> is_touched;
+
+		void sort_by_score();
+		void init_dynamic();
+		void score_clause(int c, double sign);				// adds sign * its JW weight to its free vars' pending.
+		void apply_pending();								// moves pending into score, one heap fix per var.
+		void update_var(int var, const Assignment & vals);	// moves seen's var to its state in vals.
+		bool heap_better(int a, int b) const;
+		void heap_push(int var);
+		void heap_remove(int var);
+		void heap_fix(int var);								// after var's score changed.
+		void heap_move(int i, int var);
+
+	public:
+		VarOrder(){ expr=NULL; type=ORDER_START; num_of_vars=0; };
+
+		void init_order(const Expression & expr, int num_of_vars, OrderType type, int first_var);
+		int get_var(int depth) const;						// var picked for depth, 0 past the end.
+		int pick_var(int depth, const Assignment & vals);	// next var to branch on below vals.
+		bool is_dynamic() const;
+};
+
+
+inline int VarOrder::get_var(int depth) const {
+	return depth < num_of_vars ? order[depth] : 0;
+}
+
+
+#endif